@@ -0,0 +1,63 @@
+#!/usr/bin/env python3
+
+# This file is part of the WarpX automated test suite. It checks the lazy
+# reconstruction of the old particle attributes for the back-transformed
+# diagnostics (warpx.do_lazy_back_transformed_particles).
+#
+# - Run the boosted-frame test twice, with the old particle attributes copied
+#   before each push, and with only the old momenta copied and the old
+#   positions reconstructed from the new positions and momenta
+# - Check that the same particles are written in the lab-frame snapshots, with
+#   the same weights, positions and momenta (up to round-off errors)
+
+import numpy as np
+import glob
+import os
+import sys
+import read_raw_data
+sys.path.insert(1, '../../../../warpx/Regression/PostProcessingUtils/')
+import compare_runs
+
+tolerance = 1.e-9
+
+species = ['electrons', 'ions', 'beam']
+
+def run(executable, lazy):
+    directory = "lab_frame_data_lazy" + str(lazy)
+    compare_runs.run(executable, "inputs_3d_slice",
+                     "warpx.do_lazy_back_transformed_particles=" + str(lazy)
+                     + " warpx.lab_data_directory=" + directory)
+    return directory
+
+def compare(directory_ref, directory):
+    snapshots = sorted(glob.glob(directory_ref + "/snapshots/snapshot*"))
+    assert(len(snapshots) > 0)
+    for snapshot_ref in snapshots:
+        snapshot = directory + "/snapshots/" + os.path.basename(snapshot_ref)
+        for s in species:
+            get_ref = lambda f: read_raw_data.get_particle_field(snapshot_ref, s, f)
+            get = lambda f: read_raw_data.get_particle_field(snapshot, s, f)
+            name = os.path.basename(snapshot_ref) + " " + s
+            assert(get_ref('w').size == get('w').size)
+            print(name + ": " + str(get_ref('w').size) + " particles")
+            if get_ref('w').size == 0:
+                continue
+            fields = ['w', 'x', 'y', 'z', 'ux', 'uy', 'uz']
+            p_ref = [get_ref(f) for f in fields]
+            p = [get(f) for f in fields]
+            # Same particles in the same order, sorted by position
+            order_ref = np.lexsort(p_ref[1:4])
+            order = np.lexsort(p[1:4])
+            for f, q_ref, q in zip(fields, p_ref, p):
+                compare_runs.check_difference(name + " " + f, q_ref[order_ref],
+                                              q[order], tolerance)
+
+def main():
+    executable = compare_runs.get_executable()
+    directory_ref = run(executable, 0)
+    directory = run(executable, 1)
+    compare(directory_ref, directory)
+    print('Passed')
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,48 @@
+#!/usr/bin/env python3
+
+# This file is part of the WarpX automated test suite. It checks that
+# scheduling the tiles by color and depositing directly into the global
+# arrays (warpx.do_colored_deposition) does not change the results, beyond
+# round-off errors.
+#
+# - Run the Langmuir wave test with and without the colored deposition,
+#   with shape factors of order 1 and 3 (which need tiles with more guard cells)
+# - Check that the fields and the particle data of the runs agree
+
+import sys
+sys.path.insert(1, '../../../../warpx/Regression/PostProcessingUtils/')
+import compare_runs
+
+# Maximum acceptable relative difference (the tiles are deposited
+# in a different order, which only changes the round-off errors)
+tolerance = 1.e-9
+
+fields = ['Ex', 'Ey', 'Ez', 'Bx', 'By', 'Bz', 'jx', 'jy', 'jz', 'rho']
+particle_fields = [('electrons', 'particle_position_x'),
+                   ('electrons', 'particle_weight'),
+                   ('electrons', 'particle_momentum_x'),
+                   ('positrons', 'particle_position_z'),
+                   ('positrons', 'particle_momentum_z')]
+
+args = "amr.n_cell='32 32 32' amr.max_grid_size=32 max_step=20 diag1.period=20"
+
+def run(executable, order, colored):
+    return compare_runs.run_plotfile(executable, "inputs_3d_multi_rt",
+                                     args + " interpolation.nox=" + str(order) +
+                                     " interpolation.noy=" + str(order) +
+                                     " interpolation.noz=" + str(order) +
+                                     " warpx.do_colored_deposition=" + str(colored),
+                                     "diags/order" + str(order) + "_colored" + str(colored) + "/plt",
+                                     20, env="OMP_NUM_THREADS=2")
+
+def main():
+    executable = compare_runs.get_executable()
+    for order in [1, 3]:
+        ds_ref = run(executable, order, 0)
+        compare_runs.compare_plotfiles(ds_ref, run(executable, order, 1), fields,
+                                       particle_fields, tolerance,
+                                       "order " + str(order) + " colored")
+    print('Passed')
+
+if __name__ == "__main__":
+    main()
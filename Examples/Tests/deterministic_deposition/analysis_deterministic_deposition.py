@@ -0,0 +1,38 @@
+#!/usr/bin/env python3
+
+# This file is part of the WarpX automated test suite. It checks that the
+# deterministic deposition (warpx.do_deterministic_deposition) gives bitwise
+# identical results with different numbers of OpenMP threads.
+#
+# - Run the Langmuir wave test with the deterministic deposition, with 1, 2
+#   and 3 OpenMP threads
+# - Check that the fields and the particle data of the runs are identical
+
+import sys
+sys.path.insert(1, '../../../../warpx/Regression/PostProcessingUtils/')
+import compare_runs
+
+fields = ['Ex', 'Ey', 'Ez', 'Bx', 'By', 'Bz', 'jx', 'jy', 'jz', 'rho']
+particle_fields = [('electrons', 'particle_weight'),
+                   ('electrons', 'particle_momentum_x'),
+                   ('positrons', 'particle_momentum_z')]
+
+args = ("amr.n_cell='32 32 32' amr.max_grid_size=32 max_step=20 diag1.period=20"
+        " warpx.do_dynamic_scheduling=0 warpx.do_deterministic_deposition=1")
+
+def run(executable, nthreads):
+    return compare_runs.run_plotfile(executable, "inputs_3d_multi_rt", args,
+                                     "diags/threads" + str(nthreads) + "/plt", 20,
+                                     env="OMP_NUM_THREADS=" + str(nthreads))
+
+def main():
+    executable = compare_runs.get_executable()
+    ds_ref = run(executable, 1)
+    for nthreads in [2, 3]:
+        # The order of the particles may depend on the number of threads
+        compare_runs.compare_plotfiles(ds_ref, run(executable, nthreads), fields,
+                                       particle_fields, 0, str(nthreads) + " threads")
+    print('Passed')
+
+if __name__ == "__main__":
+    main()
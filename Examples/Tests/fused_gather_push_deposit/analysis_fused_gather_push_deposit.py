@@ -0,0 +1,44 @@
+#!/usr/bin/env python3
+
+# This file is part of the WarpX automated test suite. It checks that the
+# fused gather, push and deposition kernel (warpx.do_fused_gather_push_deposit)
+# gives the same results as the separate gather/push and deposition kernels.
+#
+# - Run the Langmuir wave test with the separate kernels and with the fused
+#   kernel, with the Esirkepov and the direct current deposition
+# - Check that the fields and the particle data of the runs agree
+
+import sys
+sys.path.insert(1, '../../../../warpx/Regression/PostProcessingUtils/')
+import compare_runs
+
+fields = ['Ex', 'Ey', 'Ez', 'Bx', 'By', 'Bz', 'jx', 'jy', 'jz']
+particle_fields = [('electrons', 'particle_position_x'),
+                   ('electrons', 'particle_weight'),
+                   ('electrons', 'particle_momentum_x'),
+                   ('positrons', 'particle_position_z'),
+                   ('positrons', 'particle_momentum_z')]
+
+# The compiler may contract the operations differently in the fused kernel:
+# allow for a small relative difference
+tolerance = 1.e-9
+
+args = "amr.n_cell='32 32 32' amr.max_grid_size=32 max_step=20 diag1.period=20"
+
+def run(executable, algo, fused):
+    prefix = "diags/" + algo + "_fused" + str(fused) + "/plt"
+    return compare_runs.run_plotfile(executable, "inputs_3d_multi_rt",
+                                     args + " algo.current_deposition=" + algo +
+                                     " warpx.do_fused_gather_push_deposit=" + str(fused),
+                                     prefix, 20)
+
+def main():
+    executable = compare_runs.get_executable()
+    for algo in ['esirkepov', 'direct']:
+        ds_ref = run(executable, algo, 0)
+        compare_runs.compare_plotfiles(ds_ref, run(executable, algo, 1), fields,
+                                       particle_fields, tolerance, algo + " fused")
+    print('Passed')
+
+if __name__ == "__main__":
+    main()
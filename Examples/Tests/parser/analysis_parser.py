@@ -0,0 +1,61 @@
+#! /usr/bin/env python
+
+# This script checks the particles initialized with parser expressions
+# (see inputs). The weights and momenta of the particles are compared
+# with the same expressions evaluated with numpy at the particle
+# positions, and the total of the histogram computed with a parser
+# function is compared with the total weight of the particles.
+# The time step is small enough for the particles not to move.
+# The test is also run with particles injected at random positions
+# (NRandomPerCell, with the same number of particles per cell), which
+# checks that the parsers are evaluated at the final particle positions.
+
+import sys
+import numpy as np
+import scipy.constants as scc
+import yt
+yt.funcs.mylog.setLevel(0)
+from read_raw_data import read_reduced_diags_histogram
+
+tolerance = 1.e-6
+
+n0 = 1.e21
+u0 = 0.01
+dV = (2.0/8)**3
+ppc = 8 # 2x2x2, or 8 random particles per cell
+
+fn = sys.argv[1]
+ds = yt.load( fn )
+ad = ds.all_data()
+x = ad['electrons', 'particle_position_x'].to_ndarray()
+y = ad['electrons', 'particle_position_y'].to_ndarray()
+z = ad['electrons', 'particle_position_z'].to_ndarray()
+w = ad['electrons', 'particle_weight'].to_ndarray()
+ux = ad['electrons', 'particle_momentum_x'].to_ndarray()/(scc.m_e*scc.c)
+uy = ad['electrons', 'particle_momentum_y'].to_ndarray()/(scc.m_e*scc.c)
+uz = ad['electrons', 'particle_momentum_z'].to_ndarray()/(scc.m_e*scc.c)
+
+n = n0*(1.0 + 0.5*np.sin(-2.0*x + y/3.0))*np.exp(-(x**2 + z**2)/4.0) - 0.1*n0*np.cos(z)
+w_th = n*dV/ppc
+ux_th = -u0*np.tanh(2.0*x - y) + 0.5*u0*z
+uy_th = u0*np.cos(np.sqrt(x**2 + y**2 + 1.0))*(-y)
+uz_th = u0*z**2 - u0*3.0/(2.0 + x)
+
+w_error = np.amax(np.abs(w - w_th))/np.amax(w_th)
+u_error = max(np.amax(np.abs(ux - ux_th)),
+              np.amax(np.abs(uy - uy_th)),
+              np.amax(np.abs(uz - uz_th)))/u0
+
+# All the values of the histogram function are in the bins
+bin_data = read_reduced_diags_histogram("hparser.txt")[3]
+h_total = np.atleast_2d(bin_data)[-1].sum()
+h_error = np.abs(h_total - w.sum())/w.sum()
+
+print('weight error:', w_error)
+print('momentum error:', u_error)
+print('histogram error:', h_error)
+print('tolerance:', tolerance)
+
+assert(w_error < tolerance)
+assert(u_error < tolerance)
+assert(h_error < tolerance)
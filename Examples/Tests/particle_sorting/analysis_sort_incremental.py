@@ -0,0 +1,47 @@
+#!/usr/bin/env python3
+
+# This file is part of the WarpX automated test suite. It checks that the
+# incremental sort of the particles (warpx.sort_incremental) does not change
+# the results, beyond round-off errors.
+#
+# - Run the Langmuir wave test without sorting, with a full sort every 5 steps,
+#   and with a full sort every 5 steps and an incremental sort at the other steps
+# - Compare the fields and the particle data of the sorted runs with those of
+#   the run without sorting
+
+import sys
+sys.path.insert(1, '../../../../warpx/Regression/PostProcessingUtils/')
+import compare_runs
+
+# Maximum acceptable relative difference (the particles are deposited
+# in a different order, which only changes the round-off errors)
+tolerance = 1.e-9
+
+fields = ['Ex', 'Ey', 'Ez', 'Bx', 'By', 'Bz', 'jx', 'jy', 'jz', 'rho']
+particle_fields = [('electrons', 'particle_position_x'),
+                   ('electrons', 'particle_weight'),
+                   ('electrons', 'particle_momentum_x'),
+                   ('positrons', 'particle_position_z'),
+                   ('positrons', 'particle_momentum_z')]
+
+args = ("amr.n_cell='32 32 32' amr.max_grid_size=32 max_step=20 diag1.period=20"
+        " warpx.sort_bin_size='1 1 1'")
+
+runs = {"nosort" : " warpx.sort_int=-1",
+        "sort" : " warpx.sort_int=5",
+        "incremental" : " warpx.sort_int=5 warpx.sort_incremental=1"}
+
+def run(executable, name):
+    return compare_runs.run_plotfile(executable, "inputs_3d_multi_rt", args + runs[name],
+                                     "diags/" + name + "/plt", 20)
+
+def main():
+    executable = compare_runs.get_executable()
+    ds_ref = run(executable, "nosort")
+    for name in ["sort", "incremental"]:
+        compare_runs.compare_plotfiles(ds_ref, run(executable, name), fields,
+                                       particle_fields, tolerance, name)
+    print('Passed')
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,42 @@
+#!/usr/bin/env python3
+
+# This file is part of the WarpX automated test suite. It checks that the
+# order in which the particles are sorted (warpx.sort_order) does not change
+# the results, beyond round-off errors.
+#
+# - Run the Langmuir wave test with the particles sorted at every step, with
+#   the lexicographic, Morton and Hilbert orders
+# - Compare the fields and the particle data of the Morton and Hilbert runs
+#   with those of the lexicographic run
+
+import sys
+sys.path.insert(1, '../../../../warpx/Regression/PostProcessingUtils/')
+import compare_runs
+
+# Maximum acceptable relative difference (the particles are deposited
+# in a different order, which only changes the round-off errors)
+tolerance = 1.e-9
+
+fields = ['Ex', 'Ey', 'Ez', 'Bx', 'By', 'Bz', 'jx', 'jy', 'jz']
+particle_fields = [('electrons', 'particle_weight'),
+                   ('electrons', 'particle_momentum_x'),
+                   ('positrons', 'particle_momentum_z')]
+
+args = ("amr.n_cell='32 32 32' amr.max_grid_size=32 max_step=20 diag1.period=20"
+        " warpx.sort_int=1 warpx.sort_bin_size='1 1 1'")
+
+def run(executable, order):
+    return compare_runs.run_plotfile(executable, "inputs_3d_multi_rt",
+                                     args + " warpx.sort_order=" + order,
+                                     "diags/" + order + "/plt", 20)
+
+def main():
+    executable = compare_runs.get_executable()
+    ds_ref = run(executable, "lexicographic")
+    for order in ["morton", "hilbert"]:
+        compare_runs.compare_plotfiles(ds_ref, run(executable, order), fields,
+                                       particle_fields, tolerance, order)
+    print('Passed')
+
+if __name__ == "__main__":
+    main()
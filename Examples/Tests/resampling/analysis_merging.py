@@ -0,0 +1,76 @@
+#!/usr/bin/env python3
+
+# This file is part of the WarpX automated test suite. It checks that the
+# merging of the particles (<species_name>.do_resampling) conserves the
+# weight, momentum and energy of the particles of each cell.
+#
+# - Run a simulation in which the particles of a thermal plasma (100 particles
+#   per cell) are neither pushed nor deposited, and are merged at step 1 down
+#   to at most 16 particles per cell
+# - Check that the number of particles per cell decreased as expected, and
+#   that the total weight, momentum and energy of each cell did not change
+
+import sys
+import numpy as np
+import scipy.constants as scc
+sys.path.insert(1, '../../../../warpx/Regression/PostProcessingUtils/')
+import compare_runs
+
+# Maximum acceptable relative difference (round-off errors)
+tolerance = 1.e-10
+
+target_ppc = 16
+initial_ppc = 100
+
+def cell_data(ds):
+    '''Return the cell index, weight, momentum and kinetic energy of the particles.'''
+    ad = ds.all_data()
+    x = np.stack([ad['electron', 'particle_position_' + d].v for d in 'xyz'])
+    lo = ds.domain_left_edge.v[:, np.newaxis]
+    dx = ((ds.domain_right_edge.v - ds.domain_left_edge.v)/ds.domain_dimensions)[:, np.newaxis]
+    n = ds.domain_dimensions
+    i = np.clip(np.floor((x - lo)/dx).astype(int), 0, n[:, np.newaxis] - 1)
+    cell = (i[2]*n[1] + i[1])*n[0] + i[0]
+    w = ad['electron', 'particle_weight'].v
+    p = np.stack([ad['electron', 'particle_momentum_' + d].v for d in 'xyz'])
+    u2 = np.sum(p**2, axis=0)/(scc.m_e*scc.c)**2
+    # gamma-1, written so as to avoid cancellations
+    energy = scc.m_e*scc.c**2*u2/(np.sqrt(1. + u2) + 1.)
+    return cell, w, p, energy, np.prod(n)
+
+def cell_sums(cell, values, n_cells):
+    return np.bincount(cell, weights=values, minlength=n_cells)
+
+def main():
+    import yt ; yt.funcs.mylog.setLevel(50)
+    executable = compare_runs.get_executable()
+    compare_runs.run(executable, "inputs_3d", "diag1.file_prefix=diags/plt")
+    cell_0, w_0, p_0, e_0, n_cells = cell_data(yt.load("diags/plt00000/"))
+    cell_1, w_1, p_1, e_1, _ = cell_data(yt.load("diags/plt00001/"))
+
+    # Number of particles per cell
+    ppc_0 = np.bincount(cell_0, minlength=n_cells)
+    ppc_1 = np.bincount(cell_1, minlength=n_cells)
+    print("particles per cell before merging: " + str(ppc_0.min()) + " to " + str(ppc_0.max()))
+    print("particles per cell after merging: " + str(ppc_1.min()) + " to " + str(ppc_1.max()))
+    assert(np.all(ppc_0 == initial_ppc))
+    assert(np.all(ppc_1 <= target_ppc))
+    assert(np.all(ppc_1 >= 2))
+
+    # Weight, momentum and energy of each cell
+    compare_runs.check_difference("weight", cell_sums(cell_0, w_0, n_cells),
+                                  cell_sums(cell_1, w_1, n_cells), tolerance)
+    # The mean momentum is small compared to the thermal momentum:
+    # compare it relatively to the sum of the norms of the momenta
+    scale = np.amax(cell_sums(cell_0, w_0*np.sqrt(np.sum(p_0**2, axis=0)), n_cells))
+    for d in range(3):
+        error = np.amax(np.abs(cell_sums(cell_1, w_1*p_1[d], n_cells) -
+                               cell_sums(cell_0, w_0*p_0[d], n_cells)))/scale
+        print("momentum " + 'xyz'[d] + " relative difference: " + str(error))
+        assert(error < tolerance)
+    compare_runs.check_difference("energy", cell_sums(cell_0, w_0*e_0, n_cells),
+                                  cell_sums(cell_1, w_1*e_1, n_cells), tolerance)
+    print('Passed')
+
+if __name__ == "__main__":
+    main()
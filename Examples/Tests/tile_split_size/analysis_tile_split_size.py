@@ -0,0 +1,45 @@
+#!/usr/bin/env python3
+
+# This file is part of the WarpX automated test suite. It checks that pushing
+# and depositing the heavy tiles in chunks, as OpenMP tasks
+# (warpx.tile_split_size), does not change the results, beyond round-off errors.
+#
+# - Run the Langmuir wave test with and without splitting the tiles, on 2
+#   OpenMP threads (each tile contains 512 particles of each species)
+# - Check that the fields and the particle data of the runs agree
+
+import sys
+sys.path.insert(1, '../../../../warpx/Regression/PostProcessingUtils/')
+import compare_runs
+
+# Maximum acceptable relative difference (the chunks are deposited
+# in a different order, which only changes the round-off errors)
+tolerance = 1.e-9
+
+fields = ['Ex', 'Ey', 'Ez', 'Bx', 'By', 'Bz', 'jx', 'jy', 'jz', 'rho']
+particle_fields = [('electrons', 'particle_position_x'),
+                   ('electrons', 'particle_weight'),
+                   ('electrons', 'particle_momentum_x'),
+                   ('positrons', 'particle_position_z'),
+                   ('positrons', 'particle_momentum_z')]
+
+args = ("amr.n_cell='32 32 32' amr.max_grid_size=32 max_step=20 diag1.period=20"
+        " particles.tile_size='8 8 8'")
+
+def run(executable, tile_split_size):
+    return compare_runs.run_plotfile(executable, "inputs_3d_multi_rt",
+                                     args + " warpx.tile_split_size=" + str(tile_split_size),
+                                     "diags/split" + str(tile_split_size) + "/plt", 20,
+                                     env="OMP_NUM_THREADS=2")
+
+def main():
+    executable = compare_runs.get_executable()
+    ds_ref = run(executable, 0)
+    for tile_split_size in [100, 300]:
+        compare_runs.compare_plotfiles(ds_ref, run(executable, tile_split_size), fields,
+                                       particle_fields, tolerance,
+                                       "tile_split_size " + str(tile_split_size))
+    print('Passed')
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,49 @@
+#!/usr/bin/env python3
+
+# This file is part of the WarpX automated test suite. It checks that the
+# vectorized CPU current deposition (warpx.do_vectorized_deposition) gives the
+# same results as the default deposition kernels.
+#
+# - Run the Langmuir wave test with the default and the vectorized deposition,
+#   with the Esirkepov and the direct current deposition, and with shape
+#   factors of order 1 and 3
+# - Check that the fields and the particle data of the runs agree
+
+import sys
+sys.path.insert(1, '../../../../warpx/Regression/PostProcessingUtils/')
+import compare_runs
+
+fields = ['Ex', 'Ey', 'Ez', 'Bx', 'By', 'Bz', 'jx', 'jy', 'jz']
+particle_fields = [('electrons', 'particle_position_x'),
+                   ('electrons', 'particle_momentum_x'),
+                   ('positrons', 'particle_position_z'),
+                   ('positrons', 'particle_momentum_z')]
+
+# The vectorized kernels add the contributions of the particles in
+# a different order: allow for rounding errors
+tolerance = 1.e-10
+
+args = "amr.n_cell='32 32 32' amr.max_grid_size=32 max_step=20 diag1.period=20"
+
+def run(executable, algo, order, vectorized):
+    prefix = "diags/" + algo + str(order) + "_vectorized" + str(vectorized) + "/plt"
+    return compare_runs.run_plotfile(executable, "inputs_3d_multi_rt",
+                                     args + " algo.current_deposition=" + algo +
+                                     " interpolation.nox=" + str(order) +
+                                     " interpolation.noy=" + str(order) +
+                                     " interpolation.noz=" + str(order) +
+                                     " warpx.do_vectorized_deposition=" + str(vectorized),
+                                     prefix, 20)
+
+def main():
+    executable = compare_runs.get_executable()
+    for algo in ['esirkepov', 'direct']:
+        for order in [1, 3]:
+            ds_ref = run(executable, algo, order, 0)
+            compare_runs.compare_plotfiles(ds_ref, run(executable, algo, order, 1),
+                                           fields, particle_fields, tolerance,
+                                           algo + " order " + str(order) + " vectorized")
+    print('Passed')
+
+if __name__ == "__main__":
+    main()
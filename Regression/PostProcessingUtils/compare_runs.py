@@ -0,0 +1,78 @@
+#! /usr/bin/env python3
+
+'''
+Helpers for the self tests that run the WarpX executable several times, with
+different options, and compare the results of the runs. A test script uses
+them as follows:
+    > sys.path.insert(1, '../../../../warpx/Regression/PostProcessingUtils/')
+    > import compare_runs
+    > executable = compare_runs.get_executable()
+    > ds_ref = compare_runs.run_plotfile(executable, inputs, args_ref, prefix_ref, step)
+    > ds = compare_runs.run_plotfile(executable, inputs, args, prefix, step)
+    > compare_runs.compare_plotfiles(ds_ref, ds, fields, particle_fields, tolerance, label)
+'''
+
+import glob
+import os
+import numpy as np
+
+def get_executable(dim=3):
+    '''Return the name of the executable built for the test.'''
+    executables = glob.glob("main" + str(dim) + "d*")
+    assert(len(executables) == 1)
+    return executables[0]
+
+def run(executable, inputs, args="", env=""):
+    '''Run the executable with the inputs file and the command-line arguments args.
+
+    @param env Environment variables to set for the run, e.g. "OMP_NUM_THREADS=2".
+    '''
+    status = os.system(env + " ./" + executable + " " + inputs + " " + args)
+    assert(status == 0)
+
+def run_plotfile(executable, inputs, args, prefix, step, env=""):
+    '''Run the executable, writing the plotfiles of diag1 with the given prefix,
+    and return the plotfile of the given step, loaded with yt.'''
+    import yt ; yt.funcs.mylog.setLevel(50)
+    run(executable, inputs, args + " diag1.file_prefix=" + prefix, env)
+    return yt.load(prefix + str(step).zfill(5) + "/")
+
+def check_difference(name, a_ref, a, tolerance):
+    '''Assert that the arrays a and a_ref have the same shape and that their
+    maximum difference, relative to the maximum of a_ref, is below tolerance.
+    With tolerance = 0, assert that they are bitwise identical.'''
+    assert(a.shape == a_ref.shape)
+    if tolerance == 0:
+        identical = np.array_equal(a_ref, a)
+        print(name + " identical: " + str(identical))
+        assert(identical)
+        return
+    if a_ref.size == 0:
+        return
+    scale = max(np.amax(np.abs(a_ref)), np.finfo(float).tiny)
+    error = np.amax(np.abs(a - a_ref)) / scale
+    print(name + " relative difference: " + str(error))
+    assert(error < tolerance)
+
+def compare_plotfiles(ds_ref, ds, fields, particle_fields, tolerance, label):
+    '''Compare the fields on the grid of level 0, and the particle data, of two
+    plotfiles (see check_difference). The particle data are sorted before the
+    comparison, since the runs may store the particles in a different order.
+
+    @param fields Names of the fields, e.g. 'Ex'.
+    @param particle_fields (species, field) pairs, e.g. ('electrons', 'particle_weight').
+    @param label Name of the run, printed with the differences.
+    '''
+    grid_ref = ds_ref.covering_grid(level=0, left_edge=ds_ref.domain_left_edge,
+                                    dims=ds_ref.domain_dimensions)
+    grid = ds.covering_grid(level=0, left_edge=ds.domain_left_edge,
+                            dims=ds.domain_dimensions)
+    for field in fields:
+        check_difference(label + " " + field, grid_ref['boxlib', field].v,
+                         grid['boxlib', field].v, tolerance)
+
+    ad_ref = ds_ref.all_data()
+    ad = ds.all_data()
+    for field in particle_fields:
+        check_difference(label + " " + field[0] + " " + field[1],
+                         np.sort(ad_ref[field].v), np.sort(ad[field].v), tolerance)
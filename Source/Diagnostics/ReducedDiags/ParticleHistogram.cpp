@@ -8,8 +8,10 @@
 #include "ParticleHistogram.H"
 #include "WarpX.H"
 #include "Utils/WarpXUtil.H"
+#include "Particles/Pusher/GetAndSetPosition.H"
 #include <AMReX_REAL.H>
-#include <AMReX_ParticleReduce.H>
+#include <AMReX_GpuContainers.H>
+#include <cmath>
 #include <limits>
 
 using namespace amrex;
@@ -130,9 +132,7 @@ void ParticleHistogram::ComputeDiags (int step)
     auto & mypc = warpx.GetPartContainer();
 
     // get WarpXParticleContainer class object
-    auto const & myspc = mypc.GetParticleContainer(m_selected_species_id);
-
-    using PType = typename WarpXParticleContainer::SuperParticleType;
+    auto & myspc = mypc.GetParticleContainer(m_selected_species_id);
 
     // get parser
     ParserWrapper<m_nvars> *fun_partparser = m_parser.get();
@@ -140,31 +140,60 @@ void ParticleHistogram::ComputeDiags (int step)
     // declare local variables
     Real const bin_min  = m_bin_min;
     Real const bin_size = m_bin_size;
+    int const bin_num = m_bin_num;
     const bool is_unity_particle_weight =
         (m_norm == NormalizationType::unity_particle_weight) ? true : false;
 
-    for ( int i = 0; i < m_bin_num; ++i )
+    // compute the histogram: the function is evaluated once per particle,
+    // in batches over the particles of each tile, and the particle weight
+    // is added to the bin that contains the value of the function
+    Gpu::DeviceVector<Real> d_data(m_bin_num, 0.0_rt);
+    Real* const AMREX_RESTRICT dptr = d_data.dataPtr();
+
+    for ( int lev = 0; lev <= myspc.finestLevel(); ++lev )
     {
-        // compute the histogram
-        m_data[i] = ReduceSum( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        for ( WarpXParIter pti(myspc, lev); pti.isValid(); ++pti )
         {
-            auto const w  = p.rdata(PIdx::w);
-            auto const x  = p.pos(0);
-            auto const y  = p.pos(1);
-            auto const z  = p.pos(2);
-            auto const ux = p.rdata(PIdx::ux)/PhysConst::c;
-            auto const uy = p.rdata(PIdx::uy)/PhysConst::c;
-            auto const uz = p.rdata(PIdx::uz)/PhysConst::c;
-            auto const f = (*fun_partparser)(t,x,y,z,ux,uy,uz);
-            auto const f1 = bin_min + bin_size*i;
-            auto const f2 = bin_min + bin_size*(i+1);
-            if ( f > f1 && f < f2 ) {
-                if ( is_unity_particle_weight ) return 1.0_rt;
-                else return w;
-            } else return 0.0_rt;
-        });
+            auto const getPosition = GetParticlePosition(pti);
+            auto & attribs = pti.GetAttribs();
+            ParticleReal const * const AMREX_RESTRICT w  = attribs[PIdx::w ].dataPtr();
+            ParticleReal const * const AMREX_RESTRICT ux = attribs[PIdx::ux].dataPtr();
+            ParticleReal const * const AMREX_RESTRICT uy = attribs[PIdx::uy].dataPtr();
+            ParticleReal const * const AMREX_RESTRICT uz = attribs[PIdx::uz].dataPtr();
+
+            fun_partparser->evalBatch( pti.numParticles(),
+            [=] AMREX_GPU_HOST_DEVICE (long ip) noexcept
+            {
+                ParticleReal x, y, z;
+                getPosition(ip, x, y, z);
+                return GpuArray<Real,m_nvars>{ t, x, y, z,
+                    ux[ip]/PhysConst::c, uy[ip]/PhysConst::c, uz[ip]/PhysConst::c };
+            },
+            [=] AMREX_GPU_HOST_DEVICE (long ip, Real f) noexcept
+            {
+                // bin of f, whose neighbors are also checked since
+                // the bounds of the bins are subject to rounding errors
+                Real const u = (f - bin_min)/bin_size;
+                if ( !(u > -1.0_rt && u < bin_num + 1.0_rt) ) return;
+                int const ib = static_cast<int>(std::floor(u));
+                for ( int i = amrex::max(ib-1, 0); i <= amrex::min(ib+1, bin_num-1); ++i )
+                {
+                    auto const f1 = bin_min + bin_size*i;
+                    auto const f2 = bin_min + bin_size*(i+1);
+                    if ( f > f1 && f < f2 ) {
+                        HostDevice::Atomic::Add( &dptr[i],
+                            is_unity_particle_weight ? 1.0_rt : w[ip] );
+                        return;
+                    }
+                }
+            });
+        }
     }
+    Gpu::copy(Gpu::deviceToHost, d_data.begin(), d_data.end(), m_data.begin());
+
     // reduced sum over mpi ranks
     ParallelDescriptor::ReduceRealSum
         (m_data.data(), m_data.size(), ParallelDescriptor::IOProcessorNumber());
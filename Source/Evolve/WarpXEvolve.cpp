@@ -204,10 +204,13 @@ WarpX::Evolve (int numsteps)
             }
         }
 
+        mypc->doResampling(step+1);
 
         if (sort_intervals.contains(step+1)) {
             amrex::Print() << "re-sorting particles \n";
-            mypc->SortParticlesByBin(sort_bin_size);
+            mypc->SortParticlesByBin(sort_bin_size, sort_order);
+        } else if (sort_incremental) {
+            mypc->SortParticlesByBinIncremental(sort_bin_size, sort_order);
         }
 
         amrex::Print()<< "STEP " << step+1 << " ends." << " TIME = " << cur_time
@@ -516,6 +516,7 @@ LaserParticleContainer::Evolve (int lev,
             }
         }
     }
+    ReduceDepositionBuffers();
 }
 
 void
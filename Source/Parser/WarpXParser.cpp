@@ -6,6 +6,7 @@
  */
 
 #include <algorithm>
+#include <cmath>
 #include "WarpXParser.H"
 
 WarpXParser::WarpXParser (std::string const& func_body)
@@ -175,3 +176,68 @@ WarpXParser::symbols () const
 #endif
     return results;
 }
+
+std::vector<struct wp_bytecode_op>
+WarpXParser::compile () const
+{
+#ifdef _OPENMP
+    const int tid = omp_get_thread_num();
+    return wp_bytecode_compile(m_parser[tid]->ast, m_varnames[tid]);
+#else
+    return wp_bytecode_compile(m_parser->ast, m_varnames);
+#endif
+}
+
+bool
+WarpXParser::checkCompiled (std::vector<struct wp_bytecode_op> const& code) const
+{
+#ifdef _OPENMP
+    const int tid = omp_get_thread_num();
+    struct wp_parser* parser = m_parser[tid];
+    amrex::Real* vars = m_variables[tid].data();
+    const int nvars = static_cast<int>(m_varnames[tid].size());
+#else
+    struct wp_parser* parser = m_parser;
+    amrex::Real* vars = m_variables.data();
+    const int nvars = static_cast<int>(m_varnames.size());
+#endif
+    const int n = static_cast<int>(code.size());
+
+    // Points with values of both signs, and of different magnitudes
+    constexpr int npoints = 9;
+    constexpr int B = WP_BC_BATCH;
+    std::vector<amrex::Real> x(std::max(nvars,1)*B);
+    for (int l = 0; l < npoints; ++l) {
+        for (int j = 0; j < nvars; ++j) {
+            const int m = (l + 2*j) % npoints;
+            x[j*B + l] = (m % 2 == 0 ? 1. : -1.) * (0.25 + 0.75*m);
+        }
+    }
+    amrex::Real batch[B] = {};
+    wp_bytecode_eval_batch(code.data(), n, x.data(), npoints, batch);
+
+    // Same value, up to rounding, or both NaN
+    auto const same = [] (amrex::Real a, amrex::Real b) {
+        if (std::isnan(a) || std::isnan(b)) return std::isnan(a) && std::isnan(b);
+        if (a == b) return true;
+        return std::abs(a - b) <= 1.e-12*std::max(std::abs(a), std::abs(b));
+    };
+
+    bool ok = true;
+    for (int l = 0; l < npoints; ++l) {
+        amrex::Real xl[16];
+        for (int j = 0; j < nvars; ++j) {
+            vars[j] = x[j*B + l];
+            xl[j] = x[j*B + l];
+        }
+        const amrex::Real ast = wp_ast_eval<0>(parser->ast, nullptr);
+        const amrex::Real single = wp_bytecode_eval(code.data(), n, xl);
+        if (!same(ast, single) || !same(ast, batch[l])) {
+            amrex::AllPrint() << "WarpXParser::checkCompiled: " << m_expression
+                              << " at point " << l << ": " << ast << " (parser), "
+                              << single << " (compiled), " << batch[l] << " (batch)\n";
+            ok = false;
+        }
+    }
+    return ok;
+}
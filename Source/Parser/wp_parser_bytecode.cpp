@@ -0,0 +1,330 @@
+#include "wp_parser_bytecode.h"
+
+#include <AMReX.H>
+
+#include <algorithm>
+
+namespace {
+
+struct wp_bytecode_compiler
+{
+    std::vector<std::string> const& varnames;
+    std::vector<struct wp_bytecode_op> code;
+
+    /* Index of the variable of a symbol node */
+    int varindex (struct wp_node* node)
+    {
+        char const* name = ((struct wp_symbol*)node)->name;
+        auto it = std::find(varnames.begin(), varnames.end(), name);
+        if (it == varnames.end()) {
+            amrex::Abort(std::string("wp_bytecode_compile: unknown variable ") + name);
+        }
+        return static_cast<int>(it - varnames.begin());
+    }
+
+    void emit (enum wp_bytecode_t type, int i, amrex_real v)
+    {
+        code.push_back(wp_bytecode_op{type, i, v});
+    }
+
+    /* Whether the code from start on is a single push of a number or variable */
+    bool is_single (std::size_t start, enum wp_bytecode_t type) const
+    {
+        return code.size() == start+1 && code[start].type == type;
+    }
+
+    void binary (enum wp_node_t type, struct wp_node* l, struct wp_node* r)
+    {
+        const std::size_t lstart = code.size();
+        compile(l);
+        const std::size_t rstart = code.size();
+        compile(r);
+
+        const bool lnum = (rstart == lstart+1) && code[lstart].type == WP_BC_NUMBER;
+        const bool rnum = is_single(rstart, WP_BC_NUMBER);
+        const bool rsym = is_single(rstart, WP_BC_SYMBOL);
+
+        if (lnum && rnum) {
+            const amrex_real a = code[lstart].v;
+            const amrex_real b = code[rstart].v;
+            code.resize(lstart);
+            switch (type) {
+            case WP_ADD: emit(WP_BC_NUMBER, 0, a + b); break;
+            case WP_SUB: emit(WP_BC_NUMBER, 0, a - b); break;
+            case WP_MUL: emit(WP_BC_NUMBER, 0, a * b); break;
+            default:     emit(WP_BC_NUMBER, 0, a / b); break;
+            }
+        } else if (rnum || rsym) {
+            const struct wp_bytecode_op op = code[rstart];
+            code.pop_back();
+            switch (type) {
+            case WP_ADD: emit(rnum ? WP_BC_ADD_V : WP_BC_ADD_P, op.i, op.v); break;
+            case WP_SUB: emit(rnum ? WP_BC_SUB_V : WP_BC_SUB_P, op.i, op.v); break;
+            case WP_MUL: emit(rnum ? WP_BC_MUL_V : WP_BC_MUL_P, op.i, op.v); break;
+            default:     emit(rnum ? WP_BC_DIV_V : WP_BC_DIV_P, op.i, op.v); break;
+            }
+        } else if (lnum) {
+            const amrex_real a = code[lstart].v;
+            code.erase(code.begin() + lstart);
+            switch (type) {
+            case WP_ADD: emit(WP_BC_ADD_V, 0, a); break;
+            case WP_SUB: emit(WP_BC_V_SUB, 0, a); break;
+            case WP_MUL: emit(WP_BC_MUL_V, 0, a); break;
+            default:     emit(WP_BC_V_DIV, 0, a); break;
+            }
+        } else {
+            switch (type) {
+            case WP_ADD: emit(WP_BC_ADD, 0, 0.0); break;
+            case WP_SUB: emit(WP_BC_SUB, 0, 0.0); break;
+            case WP_MUL: emit(WP_BC_MUL, 0, 0.0); break;
+            default:     emit(WP_BC_DIV, 0, 0.0); break;
+            }
+        }
+    }
+
+    void compile (struct wp_node* node)
+    {
+        switch (node->type)
+        {
+        case WP_NUMBER:
+            emit(WP_BC_NUMBER, 0, ((struct wp_number*)node)->value);
+            break;
+        case WP_SYMBOL:
+            emit(WP_BC_SYMBOL, varindex(node), 0.0);
+            break;
+        case WP_ADD:
+        case WP_SUB:
+        case WP_MUL:
+        case WP_DIV:
+            binary(node->type, node->l, node->r);
+            break;
+        case WP_NEG:
+        {
+            const std::size_t start = code.size();
+            compile(node->l);
+            if (is_single(start, WP_BC_NUMBER)) {
+                code.back().v = -code.back().v;
+            } else {
+                emit(WP_BC_NEG, 0, 0.0);
+            }
+            break;
+        }
+        case WP_F1:
+        {
+            const enum wp_f1_t ftype = ((struct wp_f1*)node)->ftype;
+            const std::size_t start = code.size();
+            compile(((struct wp_f1*)node)->l);
+            if (is_single(start, WP_BC_NUMBER)) {
+                code.back().v = wp_call_f1(ftype, code.back().v);
+            } else {
+                emit(WP_BC_F1, ftype, 0.0);
+            }
+            break;
+        }
+        case WP_F2:
+        {
+            const enum wp_f2_t ftype = ((struct wp_f2*)node)->ftype;
+            const std::size_t start = code.size();
+            compile(((struct wp_f2*)node)->l);
+            const std::size_t rstart = code.size();
+            compile(((struct wp_f2*)node)->r);
+            if (rstart == start+1 && code[start].type == WP_BC_NUMBER &&
+                is_single(rstart, WP_BC_NUMBER)) {
+                const amrex_real v = wp_call_f2(ftype, code[start].v, code[rstart].v);
+                code.resize(start);
+                emit(WP_BC_NUMBER, 0, v);
+            } else {
+                emit(WP_BC_F2, ftype, 0.0);
+            }
+            break;
+        }
+        case WP_ADD_VP:
+            emit(WP_BC_SYMBOL, varindex(node->r), 0.0);
+            emit(WP_BC_ADD_V, 0, node->lvp.v);
+            break;
+        case WP_SUB_VP:
+            emit(WP_BC_SYMBOL, varindex(node->r), 0.0);
+            emit(WP_BC_V_SUB, 0, node->lvp.v);
+            break;
+        case WP_MUL_VP:
+            emit(WP_BC_SYMBOL, varindex(node->r), 0.0);
+            emit(WP_BC_MUL_V, 0, node->lvp.v);
+            break;
+        case WP_DIV_VP:
+            emit(WP_BC_SYMBOL, varindex(node->r), 0.0);
+            emit(WP_BC_V_DIV, 0, node->lvp.v);
+            break;
+        case WP_ADD_PP:
+            emit(WP_BC_SYMBOL, varindex(node->l), 0.0);
+            emit(WP_BC_ADD_P, varindex(node->r), 0.0);
+            break;
+        case WP_SUB_PP:
+            emit(WP_BC_SYMBOL, varindex(node->l), 0.0);
+            emit(WP_BC_SUB_P, varindex(node->r), 0.0);
+            break;
+        case WP_MUL_PP:
+            emit(WP_BC_SYMBOL, varindex(node->l), 0.0);
+            emit(WP_BC_MUL_P, varindex(node->r), 0.0);
+            break;
+        case WP_DIV_PP:
+            emit(WP_BC_SYMBOL, varindex(node->l), 0.0);
+            emit(WP_BC_DIV_P, varindex(node->r), 0.0);
+            break;
+        case WP_NEG_P:
+            emit(WP_BC_SYMBOL, varindex(node->l), 0.0);
+            emit(WP_BC_NEG, 0, 0.0);
+            break;
+        default:
+            amrex::AllPrint() << "wp_bytecode_compile: unknown node type " << node->type << "\n";
+            amrex::Abort();
+        }
+    }
+};
+
+}
+
+std::vector<struct wp_bytecode_op>
+wp_bytecode_compile (struct wp_node* node, std::vector<std::string> const& varnames)
+{
+    wp_bytecode_compiler compiler{varnames, {}};
+    compiler.compile(node);
+    return compiler.code;
+}
+
+int
+wp_bytecode_stack_size (struct wp_bytecode_op const* code, int n)
+{
+    int size = 0;
+    int max_size = 0;
+    for (int k = 0; k < n; ++k) {
+        switch (code[k].type) {
+        case WP_BC_NUMBER:
+        case WP_BC_SYMBOL:
+            max_size = std::max(max_size, ++size);
+            break;
+        case WP_BC_ADD:
+        case WP_BC_SUB:
+        case WP_BC_MUL:
+        case WP_BC_DIV:
+        case WP_BC_F2:
+            --size;
+            break;
+        default:
+            break;
+        }
+    }
+    return max_size;
+}
+
+void
+wp_bytecode_eval_batch (struct wp_bytecode_op const* code, int n,
+                        amrex::Real const* x, int m, amrex::Real* result)
+{
+    constexpr int B = WP_BC_BATCH;
+    amrex::Real stack[WARPX_PARSER_DEPTH][B];
+    int top = -1;
+
+    for (int k = 0; k < n; ++k)
+    {
+        struct wp_bytecode_op const& op = code[k];
+        amrex::Real const v = op.v;
+        const int xoff = op.i*B;
+        // Top of the stack (the stack operations below update it)
+        amrex::Real* a = stack[top < 0 ? 0 : top];
+        switch (op.type)
+        {
+        case WP_BC_NUMBER:
+            a = stack[++top];
+            AMREX_PRAGMA_SIMD
+            for (int l = 0; l < m; ++l) a[l] = v;
+            break;
+        case WP_BC_SYMBOL:
+            a = stack[++top];
+            AMREX_PRAGMA_SIMD
+            for (int l = 0; l < m; ++l) a[l] = x[xoff+l];
+            break;
+        case WP_BC_ADD:
+            a = stack[--top];
+            AMREX_PRAGMA_SIMD
+            for (int l = 0; l < m; ++l) a[l] = a[l] + a[B+l];
+            break;
+        case WP_BC_SUB:
+            a = stack[--top];
+            AMREX_PRAGMA_SIMD
+            for (int l = 0; l < m; ++l) a[l] = a[l] - a[B+l];
+            break;
+        case WP_BC_MUL:
+            a = stack[--top];
+            AMREX_PRAGMA_SIMD
+            for (int l = 0; l < m; ++l) a[l] = a[l] * a[B+l];
+            break;
+        case WP_BC_DIV:
+            a = stack[--top];
+            AMREX_PRAGMA_SIMD
+            for (int l = 0; l < m; ++l) a[l] = a[l] / a[B+l];
+            break;
+        case WP_BC_NEG:
+            AMREX_PRAGMA_SIMD
+            for (int l = 0; l < m; ++l) a[l] = -a[l];
+            break;
+        case WP_BC_F1:
+        {
+            enum wp_f1_t const f = static_cast<enum wp_f1_t>(op.i);
+            for (int l = 0; l < m; ++l) a[l] = wp_call_f1(f, a[l]);
+            break;
+        }
+        case WP_BC_F2:
+        {
+            enum wp_f2_t const f = static_cast<enum wp_f2_t>(op.i);
+            a = stack[--top];
+            for (int l = 0; l < m; ++l) a[l] = wp_call_f2(f, a[l], a[B+l]);
+            break;
+        }
+        case WP_BC_ADD_V:
+            AMREX_PRAGMA_SIMD
+            for (int l = 0; l < m; ++l) a[l] = a[l] + v;
+            break;
+        case WP_BC_SUB_V:
+            AMREX_PRAGMA_SIMD
+            for (int l = 0; l < m; ++l) a[l] = a[l] - v;
+            break;
+        case WP_BC_MUL_V:
+            AMREX_PRAGMA_SIMD
+            for (int l = 0; l < m; ++l) a[l] = a[l] * v;
+            break;
+        case WP_BC_DIV_V:
+            AMREX_PRAGMA_SIMD
+            for (int l = 0; l < m; ++l) a[l] = a[l] / v;
+            break;
+        case WP_BC_V_SUB:
+            AMREX_PRAGMA_SIMD
+            for (int l = 0; l < m; ++l) a[l] = v - a[l];
+            break;
+        case WP_BC_V_DIV:
+            AMREX_PRAGMA_SIMD
+            for (int l = 0; l < m; ++l) a[l] = v / a[l];
+            break;
+        case WP_BC_ADD_P:
+            AMREX_PRAGMA_SIMD
+            for (int l = 0; l < m; ++l) a[l] = a[l] + x[xoff+l];
+            break;
+        case WP_BC_SUB_P:
+            AMREX_PRAGMA_SIMD
+            for (int l = 0; l < m; ++l) a[l] = a[l] - x[xoff+l];
+            break;
+        case WP_BC_MUL_P:
+            AMREX_PRAGMA_SIMD
+            for (int l = 0; l < m; ++l) a[l] = a[l] * x[xoff+l];
+            break;
+        case WP_BC_DIV_P:
+            AMREX_PRAGMA_SIMD
+            for (int l = 0; l < m; ++l) a[l] = a[l] / x[xoff+l];
+            break;
+        default:
+            amrex::AllPrint() << "wp_bytecode_eval_batch: unknown op " << op.type << "\n";
+            amrex::Abort();
+        }
+    }
+
+    for (int l = 0; l < m; ++l) result[l] = stack[0][l];
+}
@@ -0,0 +1,117 @@
+#ifndef WP_PARSER_BYTECODE_H_
+#define WP_PARSER_BYTECODE_H_
+
+#include "wp_parser_y.h"
+#include <AMReX_GpuQualifiers.H>
+#include <AMReX_GpuPrint.H>
+#include <AMReX_REAL.H>
+#include <AMReX_Print.H>
+#include <AMReX_Extension.H>
+
+#include <string>
+#include <vector>
+
+/* The AST is compiled into a flat program for a stack machine, which is
+ * evaluated by a loop without recursion.  Subtrees made of numbers only
+ * are folded into a number, and binary operations whose right operand
+ * (or commutative left operand) is a number or a variable are fused with
+ * that operand, so that it is not pushed on the stack.  Variables are
+ * referred to by their index in the array passed to wp_bytecode_eval.
+ */
+
+enum wp_bytecode_t {
+    WP_BC_NUMBER = 1, /* push v */
+    WP_BC_SYMBOL,     /* push x[i] */
+    WP_BC_ADD,        /* pop b, pop a, push a op b */
+    WP_BC_SUB,
+    WP_BC_MUL,
+    WP_BC_DIV,
+    WP_BC_NEG,        /* top = -top */
+    WP_BC_F1,         /* top = f1(top), with f1 of type i */
+    WP_BC_F2,         /* pop b, pop a, push f2(a,b), with f2 of type i */
+    WP_BC_ADD_V,      /* top = top op v */
+    WP_BC_SUB_V,
+    WP_BC_MUL_V,
+    WP_BC_DIV_V,
+    WP_BC_V_SUB,      /* top = v op top */
+    WP_BC_V_DIV,
+    WP_BC_ADD_P,      /* top = top op x[i] */
+    WP_BC_SUB_P,
+    WP_BC_MUL_P,
+    WP_BC_DIV_P
+};
+
+struct wp_bytecode_op {
+    enum wp_bytecode_t type;
+    int i;
+    amrex_real v;
+};
+
+/* Compile the AST. varnames[i] is the name of the variable x[i]. */
+std::vector<struct wp_bytecode_op> wp_bytecode_compile (struct wp_node* node,
+                                                        std::vector<std::string> const& varnames);
+
+/* Number of stack entries needed to evaluate the program */
+int wp_bytecode_stack_size (struct wp_bytecode_op const* code, int n);
+
+/* Number of points evaluated together by wp_bytecode_eval_batch */
+constexpr int WP_BC_BATCH = 64;
+
+/* Evaluate the program at m <= WP_BC_BATCH points on the host, with a loop
+ * over the points for each operation. x[j*WP_BC_BATCH+l] is the value of
+ * variable j at point l, and the result at point l is stored in result[l].
+ */
+void wp_bytecode_eval_batch (struct wp_bytecode_op const* code, int n,
+                             amrex::Real const* x, int m, amrex::Real* result);
+
+AMREX_GPU_HOST_DEVICE
+AMREX_FORCE_INLINE
+amrex::Real
+wp_bytecode_eval (struct wp_bytecode_op const* code, int n, amrex::Real const* x)
+{
+    amrex::Real stack[WARPX_PARSER_DEPTH];
+    int top = -1;
+
+    for (int k = 0; k < n; ++k)
+    {
+        struct wp_bytecode_op const& op = code[k];
+        switch (op.type)
+        {
+        case WP_BC_NUMBER: stack[++top] = op.v;                             break;
+        case WP_BC_SYMBOL: stack[++top] = x[op.i];                          break;
+        case WP_BC_ADD:    --top; stack[top] = stack[top] + stack[top+1];   break;
+        case WP_BC_SUB:    --top; stack[top] = stack[top] - stack[top+1];   break;
+        case WP_BC_MUL:    --top; stack[top] = stack[top] * stack[top+1];   break;
+        case WP_BC_DIV:    --top; stack[top] = stack[top] / stack[top+1];   break;
+        case WP_BC_NEG:    stack[top] = -stack[top];                        break;
+        case WP_BC_F1:
+            stack[top] = wp_call_f1(static_cast<enum wp_f1_t>(op.i), stack[top]);
+            break;
+        case WP_BC_F2:
+            --top;
+            stack[top] = wp_call_f2(static_cast<enum wp_f2_t>(op.i), stack[top], stack[top+1]);
+            break;
+        case WP_BC_ADD_V:  stack[top] = stack[top] + op.v;                  break;
+        case WP_BC_SUB_V:  stack[top] = stack[top] - op.v;                  break;
+        case WP_BC_MUL_V:  stack[top] = stack[top] * op.v;                  break;
+        case WP_BC_DIV_V:  stack[top] = stack[top] / op.v;                  break;
+        case WP_BC_V_SUB:  stack[top] = op.v - stack[top];                  break;
+        case WP_BC_V_DIV:  stack[top] = op.v / stack[top];                  break;
+        case WP_BC_ADD_P:  stack[top] = stack[top] + x[op.i];               break;
+        case WP_BC_SUB_P:  stack[top] = stack[top] - x[op.i];               break;
+        case WP_BC_MUL_P:  stack[top] = stack[top] * x[op.i];               break;
+        case WP_BC_DIV_P:  stack[top] = stack[top] / x[op.i];               break;
+        default:
+#if AMREX_DEVICE_COMPILE
+            AMREX_DEVICE_PRINTF("wp_bytecode_eval: unknown op %d\n", op.type);
+#else
+            amrex::AllPrint() << "wp_bytecode_eval: unknown op " << op.type << "\n";
+#endif
+            return 0.;
+        }
+    }
+
+    return stack[0];
+}
+
+#endif
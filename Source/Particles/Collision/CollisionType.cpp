@@ -7,6 +7,8 @@
 #include "CollisionType.H"
 #include "ShuffleFisherYates.H"
 #include "ElasticCollisionPerez.H"
+#include "CollisionNdt.H"
+#include "Utils/CounterBasedRandom.H"
 #include <WarpX.H>
 
 CollisionType::CollisionType(
@@ -38,6 +40,18 @@ CollisionType::CollisionType(
     else
         m_isSameSpecies = false;
 
+    pp.query("pair_parallel", m_pair_parallel);
+    pp.query("ndt", m_ndt);
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_ndt >= 1,
+        collision_name + ".ndt must be at least 1");
+    pp.query("adaptive_ndt", m_adaptive_ndt);
+    // The random numbers are keyed on the name of the collision type
+    // (FNV-1a hash), so that two collision types use independent streams
+    m_seed = 2166136261u;
+    for (char const c : collision_name) {
+        m_seed = (m_seed ^ static_cast<unsigned char>(c)) * 16777619u;
+    }
+
 }
 
 using namespace amrex;
@@ -47,43 +61,6 @@ using ParticleTileType = WarpXParticleContainer::ParticleTileType;
 using ParticleBins = DenseBins<ParticleType>;
 using index_type = ParticleBins::index_type;
 
-namespace {
-
-    /* Find the particles and count the particles that are in each cell.
-       Note that this does *not* rearrange particle arrays */
-    ParticleBins
-    findParticlesInEachCell( int const lev, MFIter const& mfi,
-                             ParticleTileType const& ptile) {
-
-        // Extract particle structures for this tile
-        int const np = ptile.numParticles();
-        ParticleType const* particle_ptr = ptile.GetArrayOfStructs()().data();
-
-        // Extract box properties
-        Geometry const& geom = WarpX::GetInstance().Geom(lev);
-        Box const& cbx = mfi.tilebox(IntVect::TheZeroVector()); //Cell-centered box
-        const auto lo = lbound(cbx);
-        const auto dxi = geom.InvCellSizeArray();
-        const auto plo = geom.ProbLoArray();
-
-        // Find particles that are in each cell;
-        // results are stored in the object `bins`.
-        ParticleBins bins;
-        bins.build(np, particle_ptr, cbx,
-            // Pass lambda function that returns the cell index
-            [=] AMREX_GPU_HOST_DEVICE (const ParticleType& p) noexcept -> IntVect
-            {
-                return IntVect(AMREX_D_DECL(
-                                   static_cast<int>((p.pos(0)-plo[0])*dxi[0] - lo.x),
-                                   static_cast<int>((p.pos(1)-plo[1])*dxi[1] - lo.y),
-                                   static_cast<int>((p.pos(2)-plo[2])*dxi[2] - lo.z)));
-            });
-
-        return bins;
-    }
-
-}
-
 /** Perform all binary collisions within a tile
  *
  * @param lev AMR level of the tile
@@ -91,13 +68,19 @@ namespace {
  * @param species1/2 pointer to species container
  * @param isSameSpecies true if collision is between same species
  * @param CoulombLog user input Coulomb logrithm
+ * @param ndt number of steps between two collisions (maximum number, if adaptive)
+ * @param adaptive_ndt whether the number of steps is chosen in each cell
+ *        (see AdaptiveCollisionNdt); the cells whose number of steps does not
+ *        divide `step` are then skipped
+ * @param step current time step
  *
  */
 void CollisionType::doCoulombCollisionsWithinTile
     ( int const lev, MFIter const& mfi,
     std::unique_ptr<WarpXParticleContainer>& species_1,
     std::unique_ptr<WarpXParticleContainer>& species_2,
-    bool const isSameSpecies, Real const CoulombLog )
+    bool const isSameSpecies, Real const CoulombLog,
+    int const ndt, bool const adaptive_ndt, int const step )
 {
 
     if ( isSameSpecies ) // species_1 == species_2
@@ -106,7 +89,7 @@ void CollisionType::doCoulombCollisionsWithinTile
         ParticleTileType& ptile_1 = species_1->ParticlesAt(lev, mfi);
 
         // Find the particles that are in each cell of this tile
-        ParticleBins bins_1 = findParticlesInEachCell( lev, mfi, ptile_1 );
+        ParticleBins& bins_1 = species_1->getCellBins( lev, mfi );
 
         // Loop over cells, and collide the particles in each cell
 
@@ -155,10 +138,6 @@ void CollisionType::doCoulombCollisionsWithinTile
                 // Do not collide if there is only one particle in the cell
                 if ( cell_stop_1 - cell_start_1 >= 2 )
                 {
-                    // shuffle
-                    ShuffleFisherYates(
-                        indices_1, cell_start_1, cell_half_1 );
-
 #if defined WARPX_DIM_RZ
                     int ri = (i_cell - i_cell%nz) / nz;
                     auto dV = MathConst::pi*(2.0*ri+1.0)*dr*dr*dz;
@@ -166,6 +145,25 @@ void CollisionType::doCoulombCollisionsWithinTile
                     amrex::ignore_unused(nz);
 #endif
 
+                    // Collide every ndt steps, with ndt*dt. The collision
+                    // frequency uses the density of all the particles of the cell,
+                    // not of the two halves that are paired below.
+                    Real dt_cell = ndt*dt;
+                    if ( adaptive_ndt )
+                    {
+                        int const ndt_cell = AdaptiveCollisionNdt(
+                            cell_start_1, cell_stop_1, cell_start_1, cell_stop_1,
+                            indices_1, indices_1,
+                            ux_1, uy_1, uz_1, ux_1, uy_1, uz_1, w_1, w_1,
+                            q1, q1, m1, m1, CoulombLog, dV, dt, ndt );
+                        if ( step % ndt_cell != 0 ) return;
+                        dt_cell = ndt_cell*dt;
+                    }
+
+                    // shuffle
+                    ShuffleFisherYates(
+                        indices_1, cell_start_1, cell_half_1 );
+
                     // Call the function in order to perform collisions
                     ElasticCollisionPerez(
                         cell_start_1, cell_half_1,
@@ -173,7 +171,7 @@ void CollisionType::doCoulombCollisionsWithinTile
                         indices_1, indices_1,
                         ux_1, uy_1, uz_1, ux_1, uy_1, uz_1, w_1, w_1,
                         q1, q1, m1, m1, Real(-1.0), Real(-1.0),
-                        dt, CoulombLog, dV );
+                        dt_cell, CoulombLog, dV );
                 }
             }
         );
@@ -185,8 +183,8 @@ void CollisionType::doCoulombCollisionsWithinTile
         ParticleTileType& ptile_2 = species_2->ParticlesAt(lev, mfi);
 
         // Find the particles that are in each cell of this tile
-        ParticleBins bins_1 = findParticlesInEachCell( lev, mfi, ptile_1 );
-        ParticleBins bins_2 = findParticlesInEachCell( lev, mfi, ptile_2 );
+        ParticleBins& bins_1 = species_1->getCellBins( lev, mfi );
+        ParticleBins& bins_2 = species_2->getCellBins( lev, mfi );
 
         // Loop over cells, and collide the particles in each cell
 
@@ -252,10 +250,6 @@ void CollisionType::doCoulombCollisionsWithinTile
                 if ( cell_stop_1 - cell_start_1 >= 1 &&
                      cell_stop_2 - cell_start_2 >= 1 )
                 {
-                    // shuffle
-                    ShuffleFisherYates(indices_1, cell_start_1, cell_stop_1);
-                    ShuffleFisherYates(indices_2, cell_start_2, cell_stop_2);
-
 #if defined WARPX_DIM_RZ
                     int ri = (i_cell - i_cell%nz) / nz;
                     auto dV = MathConst::pi*(2.0*ri+1.0)*dr*dr*dz;
@@ -263,16 +257,303 @@ void CollisionType::doCoulombCollisionsWithinTile
                     amrex::ignore_unused(nz);
 #endif
 
+                    // Collide every ndt steps, with ndt*dt
+                    Real dt_cell = ndt*dt;
+                    if ( adaptive_ndt )
+                    {
+                        int const ndt_cell = AdaptiveCollisionNdt(
+                            cell_start_1, cell_stop_1, cell_start_2, cell_stop_2,
+                            indices_1, indices_2,
+                            ux_1, uy_1, uz_1, ux_2, uy_2, uz_2, w_1, w_2,
+                            q1, q2, m1, m2, CoulombLog, dV, dt, ndt );
+                        if ( step % ndt_cell != 0 ) return;
+                        dt_cell = ndt_cell*dt;
+                    }
+
+                    // shuffle
+                    ShuffleFisherYates(indices_1, cell_start_1, cell_stop_1);
+                    ShuffleFisherYates(indices_2, cell_start_2, cell_stop_2);
+
                     // Call the function in order to perform collisions
                     ElasticCollisionPerez(
                         cell_start_1, cell_stop_1, cell_start_2, cell_stop_2,
                         indices_1, indices_2,
                         ux_1, uy_1, uz_1, ux_2, uy_2, uz_2, w_1, w_2,
                         q1, q2, m1, m2, Real(-1.0), Real(-1.0),
-                        dt, CoulombLog, dV );
+                        dt_cell, CoulombLog, dV );
                 }
             }
         );
     } // end if ( isSameSpecies)
 
 }
+
+namespace {
+    /** Call f(i) for 0 <= i < n: in a kernel on GPU, and distributed
+     *  dynamically over the OpenMP threads on CPU (the pair-parallel
+     *  collisions are called outside of the OpenMP loop over the tiles,
+     *  so that the threads share the work within each tile) */
+    template <typename F>
+    void PairParallelFor (int const n, F const& f)
+    {
+#ifdef AMREX_USE_GPU
+        amrex::ParallelFor(n, f);
+#else
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+        for (int i = 0; i < n; ++i) f(i);
+#endif
+    }
+}
+
+/** Perform all binary collisions within a tile, in parallel over the pairs
+ *  of particles of each cell, with a counter-based random number generator
+ *
+ * The particles of each cell are shuffled by sorting them according to a
+ * random key, drawn from a counter made of their id, cpu and the time step:
+ * the result thus does not depend on the initial order of the particles.
+ * The pairs are then formed as in ElasticCollisionPerez. When the two groups
+ * of particles of a cell have different sizes, each particle of the smaller
+ * group collides successively with several particles of the larger group:
+ * these successive collisions form a chain that is performed by one thread,
+ * while the different chains (of all the cells of the tile) are performed
+ * in parallel (by the OpenMP threads on CPU, since this function is called
+ * outside of the OpenMP loop over the tiles). The random numbers of each pair
+ * are drawn from a counter made of the id and cpu of its first particle, the
+ * time step and the index of the pair in the cell, so that they do not depend
+ * on the thread that performs it.
+ *
+ * @param lev AMR level of the tile
+ * @param mfi iterator for multifab
+ * @param species1/2 pointer to species container
+ * @param isSameSpecies true if collision is between same species
+ * @param CoulombLog user input Coulomb logrithm
+ * @param ndt number of steps between two collisions (maximum number, if adaptive)
+ * @param adaptive_ndt whether the number of steps is chosen in each cell
+ * @param step current time step
+ * @param seed key of the random numbers
+ *
+ */
+void CollisionType::doPairParallelCoulombCollisionsWithinTile
+    ( int const lev, MFIter const& mfi,
+    std::unique_ptr<WarpXParticleContainer>& species_1,
+    std::unique_ptr<WarpXParticleContainer>& species_2,
+    bool const isSameSpecies, Real const CoulombLog,
+    int const ndt, bool const adaptive_ndt,
+    int const step, std::uint32_t const seed )
+{
+    // Extract particles in the tile that `mfi` points to
+    ParticleTileType& ptile_1 = species_1->ParticlesAt(lev, mfi);
+    ParticleTileType& ptile_2 = species_2->ParticlesAt(lev, mfi);
+
+    // Find the particles that are in each cell of this tile
+    ParticleBins& bins_1 = species_1->getCellBins( lev, mfi );
+    ParticleBins& bins_2 = species_2->getCellBins( lev, mfi );
+
+    // Extract low-level data
+    int const n_cells = bins_1.numBins();
+    // - Species 1
+    int const np_1 = ptile_1.numParticles();
+    ParticleType const * const AMREX_RESTRICT pstruct_1 = ptile_1.GetArrayOfStructs()().data();
+    auto& soa_1 = ptile_1.GetStructOfArrays();
+    ParticleReal * const AMREX_RESTRICT ux_1 = soa_1.GetRealData(PIdx::ux).data();
+    ParticleReal * const AMREX_RESTRICT uy_1 = soa_1.GetRealData(PIdx::uy).data();
+    ParticleReal * const AMREX_RESTRICT uz_1 = soa_1.GetRealData(PIdx::uz).data();
+    ParticleReal const * const AMREX_RESTRICT w_1 = soa_1.GetRealData(PIdx::w).data();
+    index_type* indices_1 = bins_1.permutationPtr();
+    index_type const* cell_offsets_1 = bins_1.offsetsPtr();
+    Real q1 = species_1->getCharge();
+    Real m1 = species_1->getMass();
+    // - Species 2
+    int const np_2 = ptile_2.numParticles();
+    ParticleType const * const AMREX_RESTRICT pstruct_2 = ptile_2.GetArrayOfStructs()().data();
+    auto& soa_2 = ptile_2.GetStructOfArrays();
+    ParticleReal * const AMREX_RESTRICT ux_2 = soa_2.GetRealData(PIdx::ux).data();
+    ParticleReal * const AMREX_RESTRICT uy_2 = soa_2.GetRealData(PIdx::uy).data();
+    ParticleReal * const AMREX_RESTRICT uz_2 = soa_2.GetRealData(PIdx::uz).data();
+    ParticleReal const * const AMREX_RESTRICT w_2 = soa_2.GetRealData(PIdx::w).data();
+    index_type* indices_2 = bins_2.permutationPtr();
+    index_type const* cell_offsets_2 = bins_2.offsetsPtr();
+    Real q2 = species_2->getCharge();
+    Real m2 = species_2->getMass();
+
+    const Real dt = WarpX::GetInstance().getdt(lev);
+    Geometry const& geom = WarpX::GetInstance().Geom(lev);
+    Box const& cbx = mfi.tilebox(IntVect::TheZeroVector()); //Cell-centered box
+    const auto lo = lbound(cbx);
+    const auto hi = ubound(cbx);
+    int nz = hi.y-lo.y+1;
+#if defined WARPX_DIM_XZ
+    auto dV = geom.CellSize(0) * geom.CellSize(1);
+#elif defined WARPX_DIM_RZ
+    auto dr = geom.CellSize(0);
+    auto dz = geom.CellSize(1);
+#elif (AMREX_SPACEDIM == 3)
+    auto dV = geom.CellSize(0) * geom.CellSize(1) * geom.CellSize(2);
+#endif
+
+    // Random keys of the particles, for the reproducible shuffle
+    // (tag 1 or 2 in key1, while the pairs use tag 0 and their index
+    // in the cell as the last counter word)
+    Gpu::DeviceVector<std::uint64_t> key_hi_1(np_1), key_lo_1(np_1);
+    Gpu::DeviceVector<std::uint64_t> key_hi_2(isSameSpecies ? 0 : np_2);
+    Gpu::DeviceVector<std::uint64_t> key_lo_2(isSameSpecies ? 0 : np_2);
+    std::uint64_t * const AMREX_RESTRICT pkey_hi_1 = key_hi_1.dataPtr();
+    std::uint64_t * const AMREX_RESTRICT pkey_lo_1 = key_lo_1.dataPtr();
+    std::uint64_t * const AMREX_RESTRICT pkey_hi_2 = key_hi_2.dataPtr();
+    std::uint64_t * const AMREX_RESTRICT pkey_lo_2 = key_lo_2.dataPtr();
+    PairParallelFor( np_1, [=] AMREX_GPU_DEVICE (int i) noexcept
+    {
+        std::uint32_t c[4] = {static_cast<std::uint32_t>(pstruct_1[i].id()),
+                              static_cast<std::uint32_t>(pstruct_1[i].cpu()),
+                              static_cast<std::uint32_t>(step), 0u};
+        philox4x32(c, seed, 1u);
+        pkey_hi_1[i] = (static_cast<std::uint64_t>(c[0]) << 32) | c[1];
+        pkey_lo_1[i] = (static_cast<std::uint64_t>(c[2]) << 32) | c[3];
+    });
+    if (!isSameSpecies) {
+        PairParallelFor( np_2, [=] AMREX_GPU_DEVICE (int i) noexcept
+        {
+            std::uint32_t c[4] = {static_cast<std::uint32_t>(pstruct_2[i].id()),
+                                  static_cast<std::uint32_t>(pstruct_2[i].cpu()),
+                                  static_cast<std::uint32_t>(step), 0u};
+            philox4x32(c, seed, 2u);
+            pkey_hi_2[i] = (static_cast<std::uint64_t>(c[0]) << 32) | c[1];
+            pkey_lo_2[i] = (static_cast<std::uint64_t>(c[2]) << 32) | c[3];
+        });
+    }
+
+    // Loop over cells: shuffle, compute the densities and Debye length,
+    // and count the chains of collisions
+    Gpu::DeviceVector<Real> n1_cell(n_cells), n2_cell(n_cells);
+    Gpu::DeviceVector<Real> n12_cell(n_cells), lmdD_cell(n_cells);
+    Gpu::DeviceVector<Real> dt_cell(n_cells);
+    Gpu::DeviceVector<int> n_chains(n_cells+1, 0);
+    Gpu::DeviceVector<int> chain_offsets(n_cells+1);
+    Real * const AMREX_RESTRICT pn1 = n1_cell.dataPtr();
+    Real * const AMREX_RESTRICT pn2 = n2_cell.dataPtr();
+    Real * const AMREX_RESTRICT pn12 = n12_cell.dataPtr();
+    Real * const AMREX_RESTRICT plmdD = lmdD_cell.dataPtr();
+    Real * const AMREX_RESTRICT pdt_cell = dt_cell.dataPtr();
+    int * const AMREX_RESTRICT pn_chains = n_chains.dataPtr();
+    auto const prepare_cell =
+        [=] AMREX_GPU_DEVICE (int i_cell) noexcept
+        {
+            // Particles of each group of the cell:
+            // `indices_1[start_1:stop_1]` and `indices_2[start_2:stop_2]`
+            index_type start_1, stop_1, start_2, stop_2;
+            if ( isSameSpecies ) {
+                start_1 = cell_offsets_1[i_cell];
+                stop_2  = cell_offsets_1[i_cell+1];
+                ShuffleByRandomKey(indices_1, start_1, stop_2, pkey_hi_1, pkey_lo_1);
+                stop_1  = (start_1+stop_2)/2;
+                start_2 = stop_1;
+            } else {
+                start_1 = cell_offsets_1[i_cell];
+                stop_1  = cell_offsets_1[i_cell+1];
+                start_2 = cell_offsets_2[i_cell];
+                stop_2  = cell_offsets_2[i_cell+1];
+                ShuffleByRandomKey(indices_1, start_1, stop_1, pkey_hi_1, pkey_lo_1);
+                ShuffleByRandomKey(indices_2, start_2, stop_2, pkey_hi_2, pkey_lo_2);
+            }
+
+            // Do not collide if one group is empty
+            if ( stop_1 == start_1 || stop_2 == start_2 ) return;
+
+#if defined WARPX_DIM_RZ
+            int ri = (i_cell - i_cell%nz) / nz;
+            auto dV = MathConst::pi*(2.0*ri+1.0)*dr*dr*dz;
+#else
+            amrex::ignore_unused(nz);
+#endif
+
+            // Collide every ndt steps, with ndt*dt. For the same species,
+            // the collision frequency uses all the particles of the cell.
+            pdt_cell[i_cell] = ndt*dt;
+            if ( adaptive_ndt )
+            {
+                index_type const ndt_stop_1 = isSameSpecies ? stop_2 : stop_1;
+                index_type const ndt_start_2 = isSameSpecies ? start_1 : start_2;
+                int const ndt_cell = AdaptiveCollisionNdt(
+                    start_1, ndt_stop_1, ndt_start_2, stop_2,
+                    indices_1, indices_2,
+                    ux_1, uy_1, uz_1, ux_2, uy_2, uz_2, w_1, w_2,
+                    q1, q2, m1, m2, CoulombLog, dV, dt, ndt );
+                if ( step % ndt_cell != 0 ) return;
+                pdt_cell[i_cell] = ndt_cell*dt;
+            }
+
+            ComputePerezCellParameters(
+                start_1, stop_1, start_2, stop_2,
+                indices_1, indices_2,
+                ux_1, uy_1, uz_1, ux_2, uy_2, uz_2, w_1, w_2,
+                q1, q2, m1, m2, Real(-1.0), Real(-1.0), CoulombLog, dV,
+                pn1[i_cell], pn2[i_cell], pn12[i_cell], plmdD[i_cell] );
+
+            // One chain per particle of the smaller group
+            pn_chains[i_cell] = static_cast<int>(amrex::min(stop_1-start_1, stop_2-start_2));
+        };
+    PairParallelFor( n_cells, prepare_cell );
+    Gpu::exclusive_scan(n_chains.begin(), n_chains.end(), chain_offsets.begin());
+    int n_chains_total;
+#ifdef AMREX_USE_GPU
+    Gpu::dtoh_memcpy(&n_chains_total, chain_offsets.dataPtr()+n_cells, sizeof(int));
+#else
+    n_chains_total = chain_offsets[n_cells];
+#endif
+    int const * const AMREX_RESTRICT pchain_offsets = chain_offsets.dataPtr();
+
+    // Loop over chains of collisions
+    auto const collide_chain =
+        [=] AMREX_GPU_DEVICE (int i_chain) noexcept
+        {
+            // Find the cell of this chain: pchain_offsets[i_cell] <= i_chain < pchain_offsets[i_cell+1]
+            int i_cell = 0;
+            int i_next = n_cells;
+            while (i_next - i_cell > 1) {
+                int const mid = (i_cell + i_next)/2;
+                if (pchain_offsets[mid] <= i_chain) { i_cell = mid; } else { i_next = mid; }
+            }
+            int const j = i_chain - pchain_offsets[i_cell];
+
+            index_type start_1, stop_1, start_2, stop_2;
+            if ( isSameSpecies ) {
+                start_1 = cell_offsets_1[i_cell];
+                stop_2  = cell_offsets_1[i_cell+1];
+                stop_1  = (start_1+stop_2)/2;
+                start_2 = stop_1;
+            } else {
+                start_1 = cell_offsets_1[i_cell];
+                stop_1  = cell_offsets_1[i_cell+1];
+                start_2 = cell_offsets_2[i_cell];
+                stop_2  = cell_offsets_2[i_cell+1];
+            }
+            int const NI1 = stop_1 - start_1;
+            int const NI2 = stop_2 - start_2;
+            int const n_min = amrex::min(NI1, NI2);
+            int const n_pairs = amrex::max(NI1, NI2);
+
+            // Pairs k = j, j + n_min, j + 2*n_min, ... of the cell: all of them
+            // contain particle j of the smaller group, and different particles
+            // of the larger group
+            for (int k = j; k < n_pairs; k += n_min)
+            {
+                index_type const ip1 = indices_1[ start_1 + k%NI1 ];
+                index_type const ip2 = indices_2[ start_2 + k%NI2 ];
+                PhiloxRandom get_random(
+                    static_cast<std::uint32_t>(pstruct_1[ip1].id()),
+                    static_cast<std::uint32_t>(pstruct_1[ip1].cpu()),
+                    static_cast<std::uint32_t>(step),
+                    static_cast<std::uint32_t>(k), seed, 0u );
+                UpdateMomentumPerezElastic(
+                    ux_1[ip1], uy_1[ip1], uz_1[ip1],
+                    ux_2[ip2], uy_2[ip2], uz_2[ip2],
+                    pn1[i_cell], pn2[i_cell], pn12[i_cell],
+                    q1, m1, w_1[ip1], q2, m2, w_2[ip2],
+                    pdt_cell[i_cell], CoulombLog, plmdD[i_cell], get_random );
+            }
+        };
+    PairParallelFor( n_chains_total, collide_chain );
+    Gpu::synchronize();
+}
@@ -21,6 +21,10 @@ IonizationFilterFunc::IonizationFilterFunc (const WarpXParIter& a_pti, int lev,
                                             const amrex::Real* const AMREX_RESTRICT a_adk_prefactor,
                                             const amrex::Real* const AMREX_RESTRICT a_adk_exp_prefactor,
                                             const amrex::Real* const AMREX_RESTRICT a_adk_power,
+                                            const amrex::Real* const AMREX_RESTRICT a_adk_table,
+                                            const amrex::Real* const AMREX_RESTRICT a_adk_table_log_emin,
+                                            const amrex::Real* const AMREX_RESTRICT a_adk_table_inv_dlog,
+                                            int a_adk_table_size,
                                             int a_comp,
                                             int a_atomic_number,
                                             int a_offset) noexcept
@@ -29,6 +33,10 @@ IonizationFilterFunc::IonizationFilterFunc (const WarpXParIter& a_pti, int lev,
     m_adk_prefactor = a_adk_prefactor;
     m_adk_exp_prefactor = a_adk_exp_prefactor;
     m_adk_power = a_adk_power;
+    m_adk_table = a_adk_table;
+    m_adk_table_log_emin = a_adk_table_log_emin;
+    m_adk_table_inv_dlog = a_adk_table_inv_dlog;
+    m_adk_table_size = a_adk_table_size;
     comp = a_comp;
     m_atomic_number = a_atomic_number;
 
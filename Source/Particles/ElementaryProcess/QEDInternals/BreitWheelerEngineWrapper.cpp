@@ -33,7 +33,18 @@ BreitWheelerEngine::build_evolve_functor ()
 {
     AMREX_ALWAYS_ASSERT(m_lookup_tables_initialized);
 
-    return BreitWheelerEvolveOpticalDepth(m_innards);
+    return BreitWheelerEvolveOpticalDepth(m_innards, m_packed_rate_table.view());
+}
+
+bool BreitWheelerEngine::init_packed_rate_table (amrex::Real rel_error)
+{
+    AMREX_ALWAYS_ASSERT(m_lookup_tables_initialized);
+
+    return m_packed_rate_table.build(
+        m_innards.TTfunc_coords.dataPtr(),
+        static_cast<int>(m_innards.TTfunc_coords.size()),
+        m_innards.ctrl.chi_phot_min, BreitWheelerEvolveOpticalDepth(m_innards),
+        true, rel_error, "Breit Wheeler");
 }
 
 BreitWheelerGeneratePairs
@@ -176,14 +187,7 @@ Vector<char> BreitWheelerEngine::export_lookup_tables_data () const
     if(!m_lookup_tables_initialized)
         return res;
 
-    add_data_to_vector_char(&m_innards.ctrl.chi_phot_min, 1, res);
-    add_data_to_vector_char(&m_innards.ctrl.chi_phot_tdndt_min, 1, res);
-    add_data_to_vector_char(&m_innards.ctrl.chi_phot_tdndt_max, 1, res);
-    add_data_to_vector_char(&m_innards.ctrl.chi_phot_tdndt_how_many, 1, res);
-    add_data_to_vector_char(&m_innards.ctrl.chi_phot_tpair_min, 1, res);
-    add_data_to_vector_char(&m_innards.ctrl.chi_phot_tpair_max, 1, res);
-    add_data_to_vector_char(&m_innards.ctrl.chi_phot_tpair_how_many, 1, res);
-    add_data_to_vector_char(&m_innards.ctrl.chi_frac_tpair_how_many, 1, res);
+    res = export_ctrl_data(m_innards.ctrl);
 
     add_data_to_vector_char(m_innards.TTfunc_coords.data(),
         m_innards.TTfunc_coords.size(), res);
@@ -199,6 +203,22 @@ Vector<char> BreitWheelerEngine::export_lookup_tables_data () const
     return res;
 }
 
+Vector<char> BreitWheelerEngine::export_ctrl_data (const PicsarBreitWheelerCtrl& ctrl)
+{
+    Vector<char> res{};
+
+    add_data_to_vector_char(&ctrl.chi_phot_min, 1, res);
+    add_data_to_vector_char(&ctrl.chi_phot_tdndt_min, 1, res);
+    add_data_to_vector_char(&ctrl.chi_phot_tdndt_max, 1, res);
+    add_data_to_vector_char(&ctrl.chi_phot_tdndt_how_many, 1, res);
+    add_data_to_vector_char(&ctrl.chi_phot_tpair_min, 1, res);
+    add_data_to_vector_char(&ctrl.chi_phot_tpair_max, 1, res);
+    add_data_to_vector_char(&ctrl.chi_phot_tpair_how_many, 1, res);
+    add_data_to_vector_char(&ctrl.chi_frac_tpair_how_many, 1, res);
+
+    return res;
+}
+
 PicsarBreitWheelerCtrl
 BreitWheelerEngine::get_default_ctrl() const
 {
@@ -5,6 +5,7 @@
  * License: BSD-3-Clause-LBNL
  */
 #include "QuantumSyncEngineTableBuilder.H"
+#include "QedTableBuilderHelperFunctions.H"
 
 //Include the full Quantum Synchrotron engine with table generation support
 //(after some consistency tests). This requires to have a recent version
@@ -32,6 +33,65 @@ QuantumSynchrotronEngineTableBuilder::compute_table
     (PicsarQuantumSynchrotronCtrl ctrl,
      QuantumSynchrotronEngineInnards& innards) const
 {
+    //The tables are generated in slices of their chi axis if possible
+    const auto compute_slice = [&ctrl] (
+        int first_1, int last_1, int first_2, int last_2)
+    {
+        const int how_many_1 = ctrl.chi_part_tdndt_how_many;
+        const int how_many_2 = ctrl.chi_part_tem_how_many;
+        auto slice_ctrl = ctrl;
+        slice_ctrl.chi_part_tdndt_min = QedUtils::log_grid_node(
+            ctrl.chi_part_tdndt_min, ctrl.chi_part_tdndt_max, how_many_1, first_1);
+        slice_ctrl.chi_part_tdndt_max = QedUtils::log_grid_node(
+            ctrl.chi_part_tdndt_min, ctrl.chi_part_tdndt_max, how_many_1, last_1);
+        slice_ctrl.chi_part_tdndt_how_many = last_1 - first_1 + 1;
+        slice_ctrl.chi_part_tem_min = QedUtils::log_grid_node(
+            ctrl.chi_part_tem_min, ctrl.chi_part_tem_max, how_many_2, first_2);
+        slice_ctrl.chi_part_tem_max = QedUtils::log_grid_node(
+            ctrl.chi_part_tem_min, ctrl.chi_part_tem_max, how_many_2, last_2);
+        slice_ctrl.chi_part_tem_how_many = last_2 - first_2 + 1;
+
+        PicsarQuantumSynchrotronEngine qs_engine(
+            std::move(QedUtils::DummyStruct()), 1.0, slice_ctrl);
+        qs_engine.compute_dN_dt_lookup_table();
+        qs_engine.compute_cumulative_phot_em_table();
+        const auto qs_innards_picsar = qs_engine.export_innards();
+
+        QedUtils::TableData slice;
+        slice.tab1_coords.assign(qs_innards_picsar.KKfunc_table_coords_ptr,
+            qs_innards_picsar.KKfunc_table_coords_ptr +
+            qs_innards_picsar.KKfunc_table_coords_how_many);
+        slice.tab1_data.assign(qs_innards_picsar.KKfunc_table_data_ptr,
+            qs_innards_picsar.KKfunc_table_data_ptr +
+            qs_innards_picsar.KKfunc_table_data_how_many);
+        slice.tab2_coords_1.assign(qs_innards_picsar.cum_distrib_table_coords_1_ptr,
+            qs_innards_picsar.cum_distrib_table_coords_1_ptr +
+            qs_innards_picsar.cum_distrib_table_coords_1_how_many);
+        slice.tab2_coords_2.assign(qs_innards_picsar.cum_distrib_table_coords_2_ptr,
+            qs_innards_picsar.cum_distrib_table_coords_2_ptr +
+            qs_innards_picsar.cum_distrib_table_coords_2_how_many);
+        slice.tab2_data.assign(qs_innards_picsar.cum_distrib_table_data_ptr,
+            qs_innards_picsar.cum_distrib_table_data_ptr +
+            qs_innards_picsar.cum_distrib_table_data_how_many);
+        return slice;
+    };
+
+    QedUtils::TableData table;
+    if(QedUtils::compute_tables_in_slices(
+        ctrl.chi_part_tdndt_how_many, ctrl.chi_part_tem_how_many,
+        ctrl.prob_tem_how_many, compute_slice, table)){
+        innards.ctrl = ctrl;
+        innards.KKfunc_coords.assign(table.tab1_coords.begin(), table.tab1_coords.end());
+        innards.KKfunc_data.assign(table.tab1_data.begin(), table.tab1_data.end());
+        innards.cum_distrib_coords_1.assign(
+            table.tab2_coords_1.begin(), table.tab2_coords_1.end());
+        innards.cum_distrib_coords_2.assign(
+            table.tab2_coords_2.begin(), table.tab2_coords_2.end());
+        innards.cum_distrib_data.assign(table.tab2_data.begin(), table.tab2_data.end());
+        return;
+    }
+
+    //Otherwise, they are generated at once
     PicsarQuantumSynchrotronEngine qs_engine(
         std::move(QedUtils::DummyStruct()), 1.0, ctrl);
 
@@ -32,7 +32,18 @@ QuantumSynchrotronEvolveOpticalDepth QuantumSynchrotronEngine::build_evolve_func
 {
     AMREX_ALWAYS_ASSERT(m_lookup_tables_initialized);
 
-    return QuantumSynchrotronEvolveOpticalDepth(m_innards);
+    return QuantumSynchrotronEvolveOpticalDepth(m_innards, m_packed_rate_table.view());
+}
+
+bool QuantumSynchrotronEngine::init_packed_rate_table (amrex::Real rel_error)
+{
+    AMREX_ALWAYS_ASSERT(m_lookup_tables_initialized);
+
+    return m_packed_rate_table.build(
+        m_innards.KKfunc_coords.dataPtr(),
+        static_cast<int>(m_innards.KKfunc_coords.size()),
+        m_innards.ctrl.chi_part_min, QuantumSynchrotronEvolveOpticalDepth(m_innards),
+        false, rel_error, "Quantum Synchrotron");
 }
 
 QuantumSynchrotronGeneratePhotonAndUpdateMomentum QuantumSynchrotronEngine::build_phot_em_functor ()
@@ -175,14 +186,7 @@ Vector<char> QuantumSynchrotronEngine::export_lookup_tables_data () const
     if(!m_lookup_tables_initialized)
         return res;
 
-    add_data_to_vector_char(&m_innards.ctrl.chi_part_min, 1, res);
-    add_data_to_vector_char(&m_innards.ctrl.chi_part_tdndt_min, 1, res);
-    add_data_to_vector_char(&m_innards.ctrl.chi_part_tdndt_max, 1, res);
-    add_data_to_vector_char(&m_innards.ctrl.chi_part_tdndt_how_many, 1, res);
-    add_data_to_vector_char(&m_innards.ctrl.chi_part_tem_min, 1, res);
-    add_data_to_vector_char(&m_innards.ctrl.chi_part_tem_max, 1, res);
-    add_data_to_vector_char(&m_innards.ctrl.chi_part_tem_how_many, 1, res);
-    add_data_to_vector_char(&m_innards.ctrl.prob_tem_how_many, 1, res);
+    res = export_ctrl_data(m_innards.ctrl);
 
     add_data_to_vector_char(m_innards.KKfunc_coords.data(),
         m_innards.KKfunc_coords.size(), res);
@@ -198,6 +202,22 @@ Vector<char> QuantumSynchrotronEngine::export_lookup_tables_data () const
     return res;
 }
 
+Vector<char> QuantumSynchrotronEngine::export_ctrl_data (const PicsarQuantumSynchrotronCtrl& ctrl)
+{
+    Vector<char> res{};
+
+    add_data_to_vector_char(&ctrl.chi_part_min, 1, res);
+    add_data_to_vector_char(&ctrl.chi_part_tdndt_min, 1, res);
+    add_data_to_vector_char(&ctrl.chi_part_tdndt_max, 1, res);
+    add_data_to_vector_char(&ctrl.chi_part_tdndt_how_many, 1, res);
+    add_data_to_vector_char(&ctrl.chi_part_tem_min, 1, res);
+    add_data_to_vector_char(&ctrl.chi_part_tem_max, 1, res);
+    add_data_to_vector_char(&ctrl.chi_part_tem_how_many, 1, res);
+    add_data_to_vector_char(&ctrl.prob_tem_how_many, 1, res);
+
+    return res;
+}
+
 PicsarQuantumSynchrotronCtrl
 QuantumSynchrotronEngine::get_default_ctrl() const
 {
@@ -1,6 +1,49 @@
 #include "WarpX.H"
 #include "Particles/Gather/GetExternalFields.H"
 
+void
+GetExternalField::addToArrays (long np,
+                               amrex::ParticleReal* field_x,
+                               amrex::ParticleReal* field_y,
+                               amrex::ParticleReal* field_z) const
+{
+    if (m_type == Constant)
+    {
+        const auto field_value = m_field_value;
+        amrex::ParallelFor(np, [=] AMREX_GPU_DEVICE (long i) noexcept
+        {
+            field_x[i] += field_value[0];
+            field_y[i] += field_value[1];
+            field_z[i] += field_value[2];
+        });
+    }
+    else if (m_type == Parser)
+    {
+        AMREX_ASSERT(m_xfield_partparser != nullptr);
+        AMREX_ASSERT(m_yfield_partparser != nullptr);
+        AMREX_ASSERT(m_zfield_partparser != nullptr);
+
+        const auto get_position = m_get_position;
+        const amrex::Real time = m_time;
+        const auto get_vars = [=] AMREX_GPU_HOST_DEVICE (long i) noexcept
+        {
+            amrex::ParticleReal x, y, z;
+            get_position(i, x, y, z);
+            return amrex::GpuArray<amrex::Real,4>{x, y, z, time};
+        };
+        m_xfield_partparser->evalBatch(np, get_vars,
+            [=] AMREX_GPU_HOST_DEVICE (long i, amrex::Real f) noexcept { field_x[i] += f; });
+        m_yfield_partparser->evalBatch(np, get_vars,
+            [=] AMREX_GPU_HOST_DEVICE (long i, amrex::Real f) noexcept { field_y[i] += f; });
+        m_zfield_partparser->evalBatch(np, get_vars,
+            [=] AMREX_GPU_HOST_DEVICE (long i, amrex::Real f) noexcept { field_z[i] += f; });
+    }
+    else
+    {
+        amrex::Abort("ExternalFieldInitType not known!!! \n");
+    }
+}
+
 GetExternalEField::GetExternalEField (const WarpXParIter& a_pti, int a_offset) noexcept
 {
     auto& warpx = WarpX::GetInstance();
@@ -23,6 +23,7 @@
 
 #include <limits>
 #include <algorithm>
+#include <cstdio>
 #include <string>
 
 
@@ -323,6 +324,8 @@ MultiParticleContainer::Evolve (int lev,
     if (rho) rho->setVal(0.0);
     if (crho) crho->setVal(0.0);
     for (auto& pc : allcontainers) {
+        // The particles are pushed: their cell bins must be rebuilt
+        pc->invalidateCellBins();
         pc->Evolve(lev, Ex, Ey, Ez, Bx, By, Bz, Ex_avg, Ey_avg, Ez_avg, Bx_avg, By_avg, Bz_avg, jx, jy, jz, cjx, cjy, cjz,
                    rho, crho, cEx, cEy, cEz, cBx, cBy, cBz, t, dt, a_dt_type);
     }
@@ -362,10 +365,43 @@ MultiParticleContainer::GetChargeDensity (int lev, bool local)
 }
 
 void
-MultiParticleContainer::SortParticlesByBin (amrex::IntVect bin_size)
+MultiParticleContainer::SortParticlesByBin (amrex::IntVect bin_size, int sort_order)
 {
     for (auto& pc : allcontainers) {
-        pc->SortParticlesByBin(bin_size);
+        if (sort_order == ParticleSortOrder::Lexicographic && bin_size == IntVect::TheUnitVector()) {
+            // Sorting by cell reuses (and keeps) the cached cell bins
+            pc->SortParticlesByCell();
+        } else if (sort_order == ParticleSortOrder::Lexicographic) {
+            pc->SortParticlesByBin(bin_size);
+            pc->invalidateCellBins();
+        } else {
+            pc->SortParticlesAlongCurve(bin_size, sort_order);
+            pc->invalidateCellBins();
+        }
+    }
+}
+
+void
+MultiParticleContainer::SortParticlesByBinIncremental (amrex::IntVect bin_size, int sort_order)
+{
+    for (auto& pc : allcontainers) {
+        pc->SortParticlesByBinIncremental(bin_size, sort_order);
+        pc->invalidateCellBins();
+    }
+}
+
+void
+MultiParticleContainer::doResampling (const int timestep)
+{
+    WARPX_PROFILE("MPC::doResampling");
+
+    for (auto& pc : allcontainers) {
+        if (!pc->do_resampling || !pc->resampling_intervals.contains(timestep)) continue;
+        for (int lev = 0; lev <= pc->finestLevel(); ++lev) {
+            pc->MergeParticles(lev);
+        }
+        // Remove the particles that were invalidated by the merging
+        pc->Redistribute();
     }
 }
 
@@ -678,17 +714,36 @@ MultiParticleContainer::doCoulombCollisions ()
         // Loop over refinement levels
         for (int lev = 0; lev <= species1->finestLevel(); ++lev){
 
-            // Loop over all grids/tiles at this level
+            // Collide every m_ndt steps of this level (or, if adaptive, check
+            // the cells at every step: each cell collides every 1, 2, 4, ...
+            // m_ndt steps)
+            int const step = WarpX::GetInstance().getistep(lev);
+            if (!collision->m_adaptive_ndt && step % collision->m_ndt != 0) continue;
+
+            // Loop over all grids/tiles at this level (with pair-parallel
+            // collisions, the OpenMP threads share the pairs of each tile)
 #ifdef _OPENMP
             info.SetDynamic(true);
-#pragma omp parallel if (Gpu::notInLaunchRegion())
+#pragma omp parallel if (Gpu::notInLaunchRegion() && !collision->m_pair_parallel)
 #endif
             for (MFIter mfi = species1->MakeMFIter(lev, info); mfi.isValid(); ++mfi){
 
-                CollisionType::doCoulombCollisionsWithinTile
-                    ( lev, mfi, species1, species2,
-                      collision->m_isSameSpecies,
-                      collision->m_CoulombLog );
+                if (collision->m_pair_parallel) {
+                    CollisionType::doPairParallelCoulombCollisionsWithinTile
+                        ( lev, mfi, species1, species2,
+                          collision->m_isSameSpecies,
+                          collision->m_CoulombLog,
+                          collision->m_ndt, collision->m_adaptive_ndt,
+                          step,
+                          collision->m_seed );
+                } else {
+                    CollisionType::doCoulombCollisionsWithinTile
+                        ( lev, mfi, species1, species2,
+                          collision->m_isSameSpecies,
+                          collision->m_CoulombLog,
+                          collision->m_ndt, collision->m_adaptive_ndt,
+                          step );
+                }
 
             }
         }
@@ -736,6 +791,72 @@ void MultiParticleContainer::InitQED ()
 
 }
 
+namespace
+{
+    /**
+     * Name of the file of the cache directory which holds the QED lookup
+     * table generated with the control parameters ctrl_data
+     */
+    std::string QedTableCacheFile (const std::string& cache_dir,
+                                   const std::string& prefix,
+                                   const Vector<char>& ctrl_data)
+    {
+        //The tables are stored in amrex::Real
+        Vector<char> key = ctrl_data;
+        key.push_back(static_cast<char>(sizeof(amrex::Real)));
+        return cache_dir + "/" + prefix + "_" + WarpXUtilIO::HashBinaryData(key) + ".bin";
+    }
+
+    /**
+     * Initializes the engine with the table of the cache, and copies it in
+     * table_name (unless it is the cache file itself or it is empty).
+     * Returns false (on all the processes) if the table is not in the cache,
+     * or if it was generated with other control parameters than ctrl.
+     */
+    template <typename Engine, typename Ctrl>
+    bool LoadQedTableFromCache (Engine& engine, const Ctrl& ctrl,
+                                const std::string& cache_file,
+                                const std::string& table_name)
+    {
+        int is_cached = ParallelDescriptor::IOProcessor() ? amrex::FileExists(cache_file) : 0;
+        ParallelDescriptor::Bcast(&is_cached, 1, ParallelDescriptor::IOProcessorNumber());
+        if(!is_cached) return false;
+
+        Vector<char> table_data;
+        ParallelDescriptor::ReadAndBcastFile(cache_file, table_data);
+        ParallelDescriptor::Barrier();
+
+        //Guards against hash collisions and corrupted files
+        if(!engine.init_lookup_tables_from_raw_data(table_data) ||
+           Engine::export_ctrl_data(engine.get_ref_ctrl()) != Engine::export_ctrl_data(ctrl)){
+            amrex::Warning("QED table " + cache_file +
+                " does not match the requested parameters and will be generated again");
+            return false;
+        }
+
+        if(!table_name.empty() && table_name != cache_file && ParallelDescriptor::IOProcessor()){
+            WarpXUtilIO::WriteBinaryDataOnFile(table_name, table_data);
+        }
+        return true;
+    }
+
+    /**
+     * Stores a QED lookup table in the cache (to be called by one process).
+     * The table is written in a temporary file, which is then renamed, so
+     * that the simulations that use the cache at the same time never read an
+     * incomplete table.
+     */
+    bool StoreQedTableInCache (const std::string& cache_dir,
+                               const std::string& cache_file,
+                               const Vector<char>& table_data)
+    {
+        if(!amrex::UtilCreateDirectory(cache_dir, 0755)) return false;
+        const std::string tmp_file = cache_file + "." + amrex::UniqueString();
+        if(!WarpXUtilIO::WriteBinaryDataOnFile(tmp_file, table_data)) return false;
+        return std::rename(tmp_file.c_str(), cache_file.c_str()) == 0;
+    }
+}
+
 void MultiParticleContainer::InitQuantumSync ()
 {
     std::string lookup_table_mode;
@@ -757,12 +878,7 @@ void MultiParticleContainer::InitQuantumSync ()
     }
 
     if(lookup_table_mode == "generate"){
-        amrex::Print() << "Quantum Synchrotron table will be generated. \n" ;
-#ifndef WARPX_QED_TABLE_GEN
-        amrex::Error("Error: Compile with QED_TABLE_GEN=TRUE to enable table generation!\n");
-#else
         QuantumSyncGenerateTable();
-#endif
     }
     else if(lookup_table_mode == "load"){
         amrex::Print() << "Quantum Synchrotron table will be read from file. \n" ;
@@ -787,6 +903,15 @@ void MultiParticleContainer::InitQuantumSync ()
     if(!m_shr_p_qs_engine->are_lookup_tables_initialized()){
         amrex::Abort("Table initialization has failed!");
     }
+
+    bool use_packed_rate_table = false;
+    pp.query("use_packed_rate_table", use_packed_rate_table);
+    amrex::Real packed_rate_table_rel_error = 0.0;
+    pp.query("packed_rate_table_rel_error", packed_rate_table_rel_error);
+    if(use_packed_rate_table &&
+       m_shr_p_qs_engine->init_packed_rate_table(packed_rate_table_rel_error)){
+        amrex::Print() << "Quantum Synchrotron packed rate table will be used. \n" ;
+    }
 }
 
 void MultiParticleContainer::InitBreitWheeler ()
@@ -799,12 +924,7 @@ void MultiParticleContainer::InitBreitWheeler ()
     }
 
     if(lookup_table_mode == "generate"){
-        amrex::Print() << "Breit Wheeler table will be generated. \n" ;
-#ifndef WARPX_QED_TABLE_GEN
-        amrex::Error("Error: Compile with QED_TABLE_GEN=TRUE to enable table generation!\n");
-#else
         BreitWheelerGenerateTable();
-#endif
     }
     else if(lookup_table_mode == "load"){
         amrex::Print() << "Breit Wheeler table will be read from file. \n" ;
@@ -829,6 +949,15 @@ void MultiParticleContainer::InitBreitWheeler ()
     if(!m_shr_p_bw_engine->are_lookup_tables_initialized()){
         amrex::Abort("Table initialization has failed!");
     }
+
+    bool use_packed_rate_table = false;
+    pp.query("use_packed_rate_table", use_packed_rate_table);
+    amrex::Real packed_rate_table_rel_error = 0.0;
+    pp.query("packed_rate_table_rel_error", packed_rate_table_rel_error);
+    if(use_packed_rate_table &&
+       m_shr_p_bw_engine->init_packed_rate_table(packed_rate_table_rel_error)){
+        amrex::Print() << "Breit Wheeler packed rate table will be used. \n" ;
+    }
 }
 
 void
@@ -837,84 +966,97 @@ MultiParticleContainer::QuantumSyncGenerateTable ()
     ParmParse pp("qed_qs");
     std::string table_name;
     pp.query("save_table_in", table_name);
-    if(table_name.empty())
-        amrex::Abort("qed_qs.save_table_in should be provided!");
-
-    if(ParallelDescriptor::IOProcessor()){
-        PicsarQuantumSynchrotronCtrl ctrl;
-        int t_int;
-
-        // Engine paramenter: chi_part_min is the minium chi parameter to be
-        // considered by the engine. If a lepton has chi < chi_part_min,
-        // the optical depth is not evolved and photon generation is ignored
-        if(!pp.query("chi_min", ctrl.chi_part_min))
-            amrex::Abort("qed_qs.chi_min should be provided!");
-
-        //==Table parameters==
-
-        //--- sub-table 1 (1D)
-        //These parameters are used to pre-compute a function
-        //which appears in the evolution of the optical depth
-
-        //Minimun chi for the table. If a lepton has chi < chi_part_tdndt_min,
-        //chi is considered as it were equal to chi_part_tdndt_min
-        if(!pp.query("tab_dndt_chi_min", ctrl.chi_part_tdndt_min))
-            amrex::Abort("qed_qs.tab_dndt_chi_min should be provided!");
-
-        //Maximum chi for the table. If a lepton has chi > chi_part_tdndt_max,
-        //chi is considered as it were equal to chi_part_tdndt_max
-        if(!pp.query("tab_dndt_chi_max", ctrl.chi_part_tdndt_max))
-            amrex::Abort("qed_qs.tab_dndt_chi_max should be provided!");
-
-        //How many points should be used for chi in the table
-        if(!pp.query("tab_dndt_how_many", t_int))
-            amrex::Abort("qed_qs.tab_dndt_how_many should be provided!");
-        ctrl.chi_part_tdndt_how_many = t_int;
-        //------
-
-        //--- sub-table 2 (2D)
-        //These parameters are used to pre-compute a function
-        //which is used to extract the properties of the generated
-        //photons.
-
-        //Minimun chi for the table. If a lepton has chi < chi_part_tem_min,
-        //chi is considered as it were equal to chi_part_tem_min
-        if(!pp.query("tab_em_chi_min", ctrl.chi_part_tem_min))
-            amrex::Abort("qed_qs.tab_em_chi_min should be provided!");
-
-        //Maximum chi for the table. If a lepton has chi > chi_part_tem_max,
-        //chi is considered as it were equal to chi_part_tem_max
-        if(!pp.query("tab_em_chi_max", ctrl.chi_part_tem_max))
-            amrex::Abort("qed_qs.tab_em_chi_max should be provided!");
-
-        //How many points should be used for chi in the table
-        if(!pp.query("tab_em_chi_how_many", t_int))
-            amrex::Abort("qed_qs.tab_em_chi_how_many should be provided!");
-        ctrl.chi_part_tem_how_many = t_int;
-
-        //The other axis of the table is a cumulative probability distribution
-        //(corresponding to different energies of the generated particles)
-        //This parameter is the number of different points to consider
-        if(!pp.query("tab_em_prob_how_many", t_int))
-            amrex::Abort("qed_qs.tab_em_prob_how_many should be provided!");
-        ctrl.prob_tem_how_many = t_int;
-        //====================
-
-        m_shr_p_qs_engine->compute_lookup_tables(ctrl);
-        WarpXUtilIO::WriteBinaryDataOnFile(table_name,
-            m_shr_p_qs_engine->export_lookup_tables_data());
+    std::string cache_dir;
+    pp.query("table_cache_dir", cache_dir);
+    if(table_name.empty() && cache_dir.empty())
+        amrex::Abort("qed_qs.save_table_in or qed_qs.table_cache_dir should be provided!");
+
+    PicsarQuantumSynchrotronCtrl ctrl;
+    int t_int;
+
+    // Engine paramenter: chi_part_min is the minium chi parameter to be
+    // considered by the engine. If a lepton has chi < chi_part_min,
+    // the optical depth is not evolved and photon generation is ignored
+    if(!pp.query("chi_min", ctrl.chi_part_min))
+        amrex::Abort("qed_qs.chi_min should be provided!");
+
+    //==Table parameters==
+
+    //--- sub-table 1 (1D)
+    //These parameters are used to pre-compute a function
+    //which appears in the evolution of the optical depth
+
+    //Minimun chi for the table. If a lepton has chi < chi_part_tdndt_min,
+    //chi is considered as it were equal to chi_part_tdndt_min
+    if(!pp.query("tab_dndt_chi_min", ctrl.chi_part_tdndt_min))
+        amrex::Abort("qed_qs.tab_dndt_chi_min should be provided!");
+
+    //Maximum chi for the table. If a lepton has chi > chi_part_tdndt_max,
+    //chi is considered as it were equal to chi_part_tdndt_max
+    if(!pp.query("tab_dndt_chi_max", ctrl.chi_part_tdndt_max))
+        amrex::Abort("qed_qs.tab_dndt_chi_max should be provided!");
+
+    //How many points should be used for chi in the table
+    if(!pp.query("tab_dndt_how_many", t_int))
+        amrex::Abort("qed_qs.tab_dndt_how_many should be provided!");
+    ctrl.chi_part_tdndt_how_many = t_int;
+    //------
+
+    //--- sub-table 2 (2D)
+    //These parameters are used to pre-compute a function
+    //which is used to extract the properties of the generated
+    //photons.
+
+    //Minimun chi for the table. If a lepton has chi < chi_part_tem_min,
+    //chi is considered as it were equal to chi_part_tem_min
+    if(!pp.query("tab_em_chi_min", ctrl.chi_part_tem_min))
+        amrex::Abort("qed_qs.tab_em_chi_min should be provided!");
+
+    //Maximum chi for the table. If a lepton has chi > chi_part_tem_max,
+    //chi is considered as it were equal to chi_part_tem_max
+    if(!pp.query("tab_em_chi_max", ctrl.chi_part_tem_max))
+        amrex::Abort("qed_qs.tab_em_chi_max should be provided!");
+
+    //How many points should be used for chi in the table
+    if(!pp.query("tab_em_chi_how_many", t_int))
+        amrex::Abort("qed_qs.tab_em_chi_how_many should be provided!");
+    ctrl.chi_part_tem_how_many = t_int;
+
+    //The other axis of the table is a cumulative probability distribution
+    //(corresponding to different energies of the generated particles)
+    //This parameter is the number of different points to consider
+    if(!pp.query("tab_em_prob_how_many", t_int))
+        amrex::Abort("qed_qs.tab_em_prob_how_many should be provided!");
+    ctrl.prob_tem_how_many = t_int;
+    //====================
+
+    std::string cache_file;
+    if(!cache_dir.empty()){
+        cache_file = QedTableCacheFile(cache_dir, "qed_qs",
+            QuantumSynchrotronEngine::export_ctrl_data(ctrl));
+        if(LoadQedTableFromCache(*m_shr_p_qs_engine, ctrl, cache_file, table_name)){
+            amrex::Print() << "Quantum Synchrotron table has been read from " << cache_file << "\n";
+            return;
+        }
+        if(table_name.empty()) table_name = cache_file;
     }
 
-    ParallelDescriptor::Barrier();
-    Vector<char> table_data;
-    ParallelDescriptor::ReadAndBcastFile(table_name, table_data);
-    ParallelDescriptor::Barrier();
+    amrex::Print() << "Quantum Synchrotron table will be generated. \n" ;
+#ifndef WARPX_QED_TABLE_GEN
+    amrex::Error("Error: Compile with QED_TABLE_GEN=TRUE to enable table generation!\n");
+#else
+    //All the processes take part in the generation, and get the whole table
+    m_shr_p_qs_engine->compute_lookup_tables(ctrl);
 
-    //No need to initialize from raw data for the processor that
-    //has just generated the table
-    if(!ParallelDescriptor::IOProcessor()){
-        m_shr_p_qs_engine->init_lookup_tables_from_raw_data(table_data);
+    if(ParallelDescriptor::IOProcessor()){
+        const auto table_data = m_shr_p_qs_engine->export_lookup_tables_data();
+        if(table_name != cache_file)
+            WarpXUtilIO::WriteBinaryDataOnFile(table_name, table_data);
+        if(!cache_file.empty() && !StoreQedTableInCache(cache_dir, cache_file, table_data))
+            amrex::Abort("Quantum Synchrotron table cannot be written in " + cache_dir);
     }
+    ParallelDescriptor::Barrier();
+#endif
 }
 
 void
@@ -923,84 +1065,97 @@ MultiParticleContainer::BreitWheelerGenerateTable ()
     ParmParse pp("qed_bw");
     std::string table_name;
     pp.query("save_table_in", table_name);
-    if(table_name.empty())
-        amrex::Abort("qed_bw.save_table_in should be provided!");
-
-    if(ParallelDescriptor::IOProcessor()){
-        PicsarBreitWheelerCtrl ctrl;
-        int t_int;
-
-        // Engine paramenter: chi_phot_min is the minium chi parameter to be
-        // considered by the engine. If a photon has chi < chi_phot_min,
-        // the optical depth is not evolved and pair generation is ignored
-        if(!pp.query("chi_min", ctrl.chi_phot_min))
-            amrex::Abort("qed_bw.chi_min should be provided!");
-
-        //==Table parameters==
-
-        //--- sub-table 1 (1D)
-        //These parameters are used to pre-compute a function
-        //which appears in the evolution of the optical depth
-
-        //Minimun chi for the table. If a photon has chi < chi_phot_tdndt_min,
-        //an analytical approximation is used.
-        if(!pp.query("tab_dndt_chi_min", ctrl.chi_phot_tdndt_min))
-            amrex::Abort("qed_bw.tab_dndt_chi_min should be provided!");
-
-        //Maximum chi for the table. If a photon has chi > chi_phot_tdndt_min,
-        //an analytical approximation is used.
-        if(!pp.query("tab_dndt_chi_max", ctrl.chi_phot_tdndt_max))
-            amrex::Abort("qed_bw.tab_dndt_chi_max should be provided!");
-
-        //How many points should be used for chi in the table
-        if(!pp.query("tab_dndt_how_many", t_int))
-            amrex::Abort("qed_bw.tab_dndt_how_many should be provided!");
-        ctrl.chi_phot_tdndt_how_many = t_int;
-        //------
-
-        //--- sub-table 2 (2D)
-        //These parameters are used to pre-compute a function
-        //which is used to extract the properties of the generated
-        //particles.
-
-        //Minimun chi for the table. If a photon has chi < chi_phot_tpair_min
-        //chi is considered as it were equal to chi_phot_tpair_min
-        if(!pp.query("tab_pair_chi_min", ctrl.chi_phot_tpair_min))
-            amrex::Abort("qed_bw.tab_pair_chi_min should be provided!");
-
-        //Maximum chi for the table. If a photon has chi > chi_phot_tpair_max
-        //chi is considered as it were equal to chi_phot_tpair_max
-        if(!pp.query("tab_pair_chi_max", ctrl.chi_phot_tpair_max))
-            amrex::Abort("qed_bw.tab_pair_chi_max should be provided!");
-
-        //How many points should be used for chi in the table
-        if(!pp.query("tab_pair_chi_how_many", t_int))
-            amrex::Abort("qed_bw.tab_pair_chi_how_many should be provided!");
-        ctrl.chi_phot_tpair_how_many = t_int;
-
-        //The other axis of the table is the fraction of the initial energy
-        //'taken away' by the most energetic particle of the pair.
-        //This parameter is the number of different fractions to consider
-        if(!pp.query("tab_pair_frac_how_many", t_int))
-            amrex::Abort("qed_bw.tab_pair_frac_how_many should be provided!");
-        ctrl.chi_frac_tpair_how_many = t_int;
-        //====================
-
-        m_shr_p_bw_engine->compute_lookup_tables(ctrl);
-        WarpXUtilIO::WriteBinaryDataOnFile(table_name,
-            m_shr_p_bw_engine->export_lookup_tables_data());
+    std::string cache_dir;
+    pp.query("table_cache_dir", cache_dir);
+    if(table_name.empty() && cache_dir.empty())
+        amrex::Abort("qed_bw.save_table_in or qed_bw.table_cache_dir should be provided!");
+
+    PicsarBreitWheelerCtrl ctrl;
+    int t_int;
+
+    // Engine paramenter: chi_phot_min is the minium chi parameter to be
+    // considered by the engine. If a photon has chi < chi_phot_min,
+    // the optical depth is not evolved and pair generation is ignored
+    if(!pp.query("chi_min", ctrl.chi_phot_min))
+        amrex::Abort("qed_bw.chi_min should be provided!");
+
+    //==Table parameters==
+
+    //--- sub-table 1 (1D)
+    //These parameters are used to pre-compute a function
+    //which appears in the evolution of the optical depth
+
+    //Minimun chi for the table. If a photon has chi < chi_phot_tdndt_min,
+    //an analytical approximation is used.
+    if(!pp.query("tab_dndt_chi_min", ctrl.chi_phot_tdndt_min))
+        amrex::Abort("qed_bw.tab_dndt_chi_min should be provided!");
+
+    //Maximum chi for the table. If a photon has chi > chi_phot_tdndt_min,
+    //an analytical approximation is used.
+    if(!pp.query("tab_dndt_chi_max", ctrl.chi_phot_tdndt_max))
+        amrex::Abort("qed_bw.tab_dndt_chi_max should be provided!");
+
+    //How many points should be used for chi in the table
+    if(!pp.query("tab_dndt_how_many", t_int))
+        amrex::Abort("qed_bw.tab_dndt_how_many should be provided!");
+    ctrl.chi_phot_tdndt_how_many = t_int;
+    //------
+
+    //--- sub-table 2 (2D)
+    //These parameters are used to pre-compute a function
+    //which is used to extract the properties of the generated
+    //particles.
+
+    //Minimun chi for the table. If a photon has chi < chi_phot_tpair_min
+    //chi is considered as it were equal to chi_phot_tpair_min
+    if(!pp.query("tab_pair_chi_min", ctrl.chi_phot_tpair_min))
+        amrex::Abort("qed_bw.tab_pair_chi_min should be provided!");
+
+    //Maximum chi for the table. If a photon has chi > chi_phot_tpair_max
+    //chi is considered as it were equal to chi_phot_tpair_max
+    if(!pp.query("tab_pair_chi_max", ctrl.chi_phot_tpair_max))
+        amrex::Abort("qed_bw.tab_pair_chi_max should be provided!");
+
+    //How many points should be used for chi in the table
+    if(!pp.query("tab_pair_chi_how_many", t_int))
+        amrex::Abort("qed_bw.tab_pair_chi_how_many should be provided!");
+    ctrl.chi_phot_tpair_how_many = t_int;
+
+    //The other axis of the table is the fraction of the initial energy
+    //'taken away' by the most energetic particle of the pair.
+    //This parameter is the number of different fractions to consider
+    if(!pp.query("tab_pair_frac_how_many", t_int))
+        amrex::Abort("qed_bw.tab_pair_frac_how_many should be provided!");
+    ctrl.chi_frac_tpair_how_many = t_int;
+    //====================
+
+    std::string cache_file;
+    if(!cache_dir.empty()){
+        cache_file = QedTableCacheFile(cache_dir, "qed_bw",
+            BreitWheelerEngine::export_ctrl_data(ctrl));
+        if(LoadQedTableFromCache(*m_shr_p_bw_engine, ctrl, cache_file, table_name)){
+            amrex::Print() << "Breit Wheeler table has been read from " << cache_file << "\n";
+            return;
+        }
+        if(table_name.empty()) table_name = cache_file;
     }
 
-    ParallelDescriptor::Barrier();
-    Vector<char> table_data;
-    ParallelDescriptor::ReadAndBcastFile(table_name, table_data);
-    ParallelDescriptor::Barrier();
+    amrex::Print() << "Breit Wheeler table will be generated. \n" ;
+#ifndef WARPX_QED_TABLE_GEN
+    amrex::Error("Error: Compile with QED_TABLE_GEN=TRUE to enable table generation!\n");
+#else
+    //All the processes take part in the generation, and get the whole table
+    m_shr_p_bw_engine->compute_lookup_tables(ctrl);
 
-    //No need to initialize from raw data for the processor that
-    //has just generated the table
-    if(!ParallelDescriptor::IOProcessor()){
-        m_shr_p_bw_engine->init_lookup_tables_from_raw_data(table_data);
+    if(ParallelDescriptor::IOProcessor()){
+        const auto table_data = m_shr_p_bw_engine->export_lookup_tables_data();
+        if(table_name != cache_file)
+            WarpXUtilIO::WriteBinaryDataOnFile(table_name, table_data);
+        if(!cache_file.empty() && !StoreQedTableInCache(cache_dir, cache_file, table_data))
+            amrex::Abort("Breit Wheeler table cannot be written in " + cache_dir);
     }
+    ParallelDescriptor::Barrier();
+#endif
 }
 
 void
@@ -1087,6 +1242,7 @@ MultiParticleContainer::doQEDSchwinger ()
         const auto np_ele_dst = dst_ele_tile.numParticles();
         const auto np_pos_dst = dst_pos_tile.numParticles();
 
+        const auto Candidate = SchwingerCandidateFunc{};
         const auto Filter  = SchwingerFilterFunc{
                               m_qed_schwinger_threshold_poisson_gaussian,dVdt};
 
@@ -1100,7 +1256,7 @@ MultiParticleContainer::doQEDSchwinger ()
 
         const auto num_added = filterCreateTransformFromFAB<1>( dst_ele_tile,
                               dst_pos_tile, box, array_EMFAB, np_ele_dst,
-                               np_pos_dst,Filter, CreateEle, CreatePos,
+                               np_pos_dst, Candidate, Filter, CreateEle, CreatePos,
                                 Transform);
 
         setNewParticleIDs(dst_ele_tile, np_ele_dst, num_added);
@@ -17,9 +17,14 @@
 #include "Python/WarpXWrappers.h"
 #include "Utils/IonizationEnergiesTable.H"
 #include "Particles/Gather/FieldGather.H"
+#include "Particles/Gather/VectorizedFieldGather.H"
+#include "Particles/Deposition/CurrentDeposition.H"
+#include "Particles/Deposition/DepositionBox.H"
+#include "Particles/Deposition/TileColoring.H"
 #include "Particles/Pusher/GetAndSetPosition.H"
 #include "Particles/Pusher/CopyParticleAttribs.H"
 #include "Particles/Pusher/PushSelector.H"
+#include "Particles/Pusher/UpdatePositionPhoton.H"
 #include "Particles/Gather/GetExternalFields.H"
 #include "Utils/WarpXAlgorithmSelection.H"
 
@@ -29,8 +34,10 @@
 #   include <openPMD/openPMD.hpp>
 #endif
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
+#include <map>
 #include <sstream>
 #include <string>
 
@@ -86,6 +93,21 @@ namespace
 #endif
         return pos;
     }
+
+    // Position of a particle before a push of duration dt, from its position
+    // and momentum after the push: the position update uses the new momentum,
+    // so that this is exact up to round-off.
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    void getOldPosition (ParticleReal& x, ParticleReal& y, ParticleReal& z,
+                         const ParticleReal ux, const ParticleReal uy, const ParticleReal uz,
+                         const bool is_photon, const Real dt) noexcept
+    {
+        if (is_photon) {
+            UpdatePositionPhoton(x, y, z, ux, uy, uz, -dt);
+        } else {
+            UpdatePosition(x, y, z, ux, uy, uz, -dt);
+        }
+    }
 }
 
 PhysicalParticleContainer::PhysicalParticleContainer (AmrCore* amr_core, int ispecies,
@@ -108,6 +130,17 @@ PhysicalParticleContainer::PhysicalParticleContainer (AmrCore* amr_core, int isp
     // Initialize splitting
     pp.query("do_splitting", do_splitting);
     pp.query("split_type", split_type);
+
+    // Initialize resampling
+    pp.query("do_resampling", do_resampling);
+    if (do_resampling) {
+        pp.get("resampling_target_ppc", resampling_target_ppc);
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(resampling_target_ppc >= 2,
+            species_name + ".resampling_target_ppc must be at least 2");
+        std::string resampling_int_string = "1";
+        pp.query("resampling_intervals", resampling_int_string);
+        resampling_intervals = IntervalsParser(resampling_int_string);
+    }
     pp.query("do_not_deposit", do_not_deposit);
     pp.query("do_not_gather", do_not_gather);
     pp.query("do_not_push", do_not_push);
@@ -120,6 +153,10 @@ PhysicalParticleContainer::PhysicalParticleContainer (AmrCore* amr_core, int isp
     pp.query("do_back_transformed_diagnostics", do_back_transformed_diagnostics);
 
     pp.query("do_field_ionization", do_field_ionization);
+    // Merged particles must have the same ionization level
+    WarpXUtilMsg::AlwaysAssert(!(do_resampling && do_field_ionization),
+        "ERROR: can't enable resampling for the ionizable species '"
+        + species_name + "'");
 
     //check if Radiation Reaction is enabled and do consistency checks
     pp.query("do_classical_radiation_reaction", do_classical_radiation_reaction);
@@ -138,6 +175,7 @@ PhysicalParticleContainer::PhysicalParticleContainer (AmrCore* amr_core, int isp
         !(do_classical_radiation_reaction &&
         WarpX::particle_pusher_algo != ParticlePusherAlgo::Boris),
         "Radiation reaction can be enabled only if Boris pusher is used");
+
     //_____________________________
 
 #ifdef WARPX_QED
@@ -157,6 +195,16 @@ PhysicalParticleContainer::PhysicalParticleContainer (AmrCore* amr_core, int isp
             m_qed_quantum_sync_phot_product_name);
     }
 
+    //The lazy back-transformed diagnostics reconstruct the old positions
+    //from the momentum after the push, which the photon emission changes
+    WarpXUtilMsg::AlwaysAssert(
+        !(m_do_qed_quantum_sync &&
+        WarpX::do_back_transformed_diagnostics && do_back_transformed_diagnostics &&
+        WarpX::do_lazy_back_transformed_particles),
+        "ERROR: warpx.do_lazy_back_transformed_particles cannot be used with "
+        "quantum synchrotron emission (species '" + species_name + "')."
+    );
+
 
 #endif
 
@@ -744,164 +792,273 @@ PhysicalParticleContainer::AddPlasma (int lev, RealBox part_realbox)
         bool loc_do_field_ionization = do_field_ionization;
         int loc_ionization_initial_level = ionization_initial_level;
 
+        // On CPU, the density and momentum parsers are evaluated in batches
+        // over the new particles: a first pass computes the positions of the
+        // particles and records the points where the parsers are evaluated,
+        // and a second pass initializes the particles with the results.
+        // The positions in the unit box (and theta in RZ) are drawn in the
+        // first pass only, so that both passes place the particles at the
+        // same points (they are random with NRandomPerCell).
+        bool batch_density = false;
+        bool batch_momentum = false;
+#ifndef AMREX_USE_GPU
+        batch_density = inj_rho->isParser();
+        batch_momentum = inj_mom->isParser();
+#endif
+        const bool batch_parsers = batch_density || batch_momentum;
+        const long n_batch = batch_parsers ? max_new_particles : 0;
+        // For each new particle: x, y, z for the density, z for the momentum,
+        // then density, ux, uy, uz, theta (RZ) and the position in the unit box
+        Gpu::DeviceVector<Real> batch_data(12*n_batch);
+        Gpu::DeviceVector<int> batch_valid(n_batch, 0);
+        Real* const peval_x = batch_data.dataPtr();
+        Real* const peval_y = peval_x + n_batch;
+        Real* const peval_z_rho = peval_x + 2*n_batch;
+        Real* const peval_z_mom = peval_x + 3*n_batch;
+        Real* const pdens = peval_x + 4*n_batch;
+        Real* const pux = peval_x + 5*n_batch;
+        Real* const puy = peval_x + 6*n_batch;
+        Real* const puz = peval_x + 7*n_batch;
+        Real* const ptheta = peval_x + 8*n_batch;
+        Real* const prx = peval_x + 9*n_batch;
+        Real* const pry = peval_x + 10*n_batch;
+        Real* const prz = peval_x + 11*n_batch;
+        int* const pvalid = batch_valid.dataPtr();
+        amrex::ignore_unused(ptheta);
+
         // Loop over all new particles and inject them (creates too many
         // particles, in particular does not consider xmin, xmax etc.).
         // The invalid ones are given negative ID and are deleted during the
         // next redistribute.
         const auto poffset = offset.data();
-        amrex::For(overlap_box, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        for (int pass = batch_parsers ? 0 : 1; pass < 2; ++pass)
         {
-            IntVect iv = IntVect(AMREX_D_DECL(i, j, k));
-            const auto index = overlap_box.index(iv);
-            for (int i_part = 0; i_part < pcounts[index]; ++i_part)
+            amrex::For(overlap_box, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
             {
-                long ip = poffset[index] + i_part;
-                ParticleType& p = pp[ip];
-                p.id() = pid+ip;
-                p.cpu() = cpuid;
-
-                const XDim3 r =
-                    inj_pos->getPositionUnitBox(i_part, lrrfac);
-                auto pos = getCellCoords(overlap_corner, dx, r, iv);
+                IntVect iv = IntVect(AMREX_D_DECL(i, j, k));
+                const auto index = overlap_box.index(iv);
+                for (int i_part = 0; i_part < pcounts[index]; ++i_part)
+                {
+                    long ip = poffset[index] + i_part;
+                    ParticleType& p = pp[ip];
+                    p.id() = pid+ip;
+                    p.cpu() = cpuid;
+
+                    XDim3 r;
+                    if (pass == 1 && batch_parsers) {
+                        // Position chosen in the first pass
+                        r = XDim3{prx[ip], pry[ip], prz[ip]};
+                    } else {
+                        r = inj_pos->getPositionUnitBox(i_part, lrrfac);
+                    }
+                    if (pass == 0) {
+                        prx[ip] = r.x;
+                        pry[ip] = r.y;
+                        prz[ip] = r.z;
+                    }
+                    auto pos = getCellCoords(overlap_corner, dx, r, iv);
 
 #if (AMREX_SPACEDIM == 3)
-                if (!tile_realbox.contains(XDim3{pos.x,pos.y,pos.z})) {
-                    p.id() = -1;
-                    continue;
-                }
+                    if (!tile_realbox.contains(XDim3{pos.x,pos.y,pos.z})) {
+                        p.id() = -1;
+                        continue;
+                    }
 #else
-                if (!tile_realbox.contains(XDim3{pos.x,pos.z,0.0_rt})) {
-                    p.id() = -1;
-                    continue;
-                }
+                    if (!tile_realbox.contains(XDim3{pos.x,pos.z,0.0_rt})) {
+                        p.id() = -1;
+                        continue;
+                    }
 #endif
 
-                // Save the x and y values to use in the insideBounds checks.
-                // This is needed with WARPX_DIM_RZ since x and y are modified.
-                Real xb = pos.x;
-                Real yb = pos.y;
+                    // Save the x and y values to use in the insideBounds checks.
+                    // This is needed with WARPX_DIM_RZ since x and y are modified.
+                    Real xb = pos.x;
+                    Real yb = pos.y;
 
 #ifdef WARPX_DIM_RZ
-                // Replace the x and y, setting an angle theta.
-                // These x and y are used to get the momentum and density
-                Real theta;
-                if (nmodes == 1) {
-                    // With only 1 mode, the angle doesn't matter so
-                    // choose it randomly.
-                    theta = 2._rt*MathConst::pi*amrex::Random();
-                } else {
-                    theta = 2._rt*MathConst::pi*r.y;
-                }
-                pos.x = xb*std::cos(theta);
-                pos.y = xb*std::sin(theta);
-#endif
-
-                Real dens;
-                XDim3 u;
-                if (gamma_boost == 1._rt) {
-                    // Lab-frame simulation
-                    // If the particle is not within the species's
-                    // xmin, xmax, ymin, ymax, zmin, zmax, go to
-                    // the next generated particle.
-
-                    // include ballistic correction for plasma species with bulk motion
-                    const Real z0 = applyBallisticCorrection(pos, inj_mom, gamma_boost,
-                                                             beta_boost, t);
-                    if (!inj_pos->insideBounds(xb, yb, z0)) {
-                        p.id() = -1;
-                        continue;
+                    // Replace the x and y, setting an angle theta.
+                    // These x and y are used to get the momentum and density
+                    Real theta;
+                    if (pass == 1 && batch_parsers) {
+                        // Angle chosen in the first pass
+                        theta = ptheta[ip];
+                    } else if (nmodes == 1) {
+                        // With only 1 mode, the angle doesn't matter so
+                        // choose it randomly.
+                        theta = 2._rt*MathConst::pi*amrex::Random();
+                    } else {
+                        theta = 2._rt*MathConst::pi*r.y;
                     }
+                    if (pass == 0) ptheta[ip] = theta;
+                    pos.x = xb*std::cos(theta);
+                    pos.y = xb*std::sin(theta);
+#endif
 
-                    u = inj_mom->getMomentum(pos.x, pos.y, z0);
-                    dens = inj_rho->getDensity(pos.x, pos.y, z0);
+                    Real dens;
+                    XDim3 u;
+                    if (gamma_boost == 1._rt) {
+                        // Lab-frame simulation
+                        // If the particle is not within the species's
+                        // xmin, xmax, ymin, ymax, zmin, zmax, go to
+                        // the next generated particle.
 
-                    // Remove particle if density below threshold
-                    if ( dens < density_min ){
-                        p.id() = -1;
-                        continue;
-                    }
-                    // Cut density if above threshold
-                    dens = amrex::min(dens, density_max);
-                } else {
-                    // Boosted-frame simulation
-                    const Real z0_lab = applyBallisticCorrection(pos, inj_mom, gamma_boost,
+                        // include ballistic correction for plasma species with bulk motion
+                        const Real z0 = applyBallisticCorrection(pos, inj_mom, gamma_boost,
                                                                  beta_boost, t);
+                        if (!inj_pos->insideBounds(xb, yb, z0)) {
+                            p.id() = -1;
+                            continue;
+                        }
+                        if (pass == 0) {
+                            // Record the point where the parsers are evaluated
+                            pvalid[ip] = 1;
+                            peval_x[ip] = pos.x;
+                            peval_y[ip] = pos.y;
+                            peval_z_rho[ip] = z0;
+                            peval_z_mom[ip] = z0;
+                            continue;
+                        }
 
-                    // If the particle is not within the lab-frame zmin, zmax, etc.
-                    // go to the next generated particle.
-                    if (!inj_pos->insideBounds(xb, yb, z0_lab)) {
-                        p.id() = -1;
-                        continue;
-                    }
-                    // call `getDensity` with lab-frame parameters
-                    dens = inj_rho->getDensity(pos.x, pos.y, z0_lab);
-                    // Remove particle if density below threshold
-                    if ( dens < density_min ){
-                        p.id() = -1;
-                        continue;
+                        u = batch_momentum ? XDim3{pux[ip], puy[ip], puz[ip]}
+                                           : inj_mom->getMomentum(pos.x, pos.y, z0);
+                        dens = batch_density ? pdens[ip] : inj_rho->getDensity(pos.x, pos.y, z0);
+
+                        // Remove particle if density below threshold
+                        if ( dens < density_min ){
+                            p.id() = -1;
+                            continue;
+                        }
+                        // Cut density if above threshold
+                        dens = amrex::min(dens, density_max);
+                    } else {
+                        // Boosted-frame simulation
+                        const Real z0_lab = applyBallisticCorrection(pos, inj_mom, gamma_boost,
+                                                                     beta_boost, t);
+
+                        // If the particle is not within the lab-frame zmin, zmax, etc.
+                        // go to the next generated particle.
+                        if (!inj_pos->insideBounds(xb, yb, z0_lab)) {
+                            p.id() = -1;
+                            continue;
+                        }
+                        if (pass == 0) {
+                            // Record the point where the parsers are evaluated
+                            pvalid[ip] = 1;
+                            peval_x[ip] = pos.x;
+                            peval_y[ip] = pos.y;
+                            peval_z_rho[ip] = z0_lab;
+                            peval_z_mom[ip] = 0._rt;
+                            continue;
+                        }
+                        // call `getDensity` with lab-frame parameters
+                        dens = batch_density ? pdens[ip] : inj_rho->getDensity(pos.x, pos.y, z0_lab);
+                        // Remove particle if density below threshold
+                        if ( dens < density_min ){
+                            p.id() = -1;
+                            continue;
+                        }
+                        // Cut density if above threshold
+                        dens = amrex::min(dens, density_max);
+
+                        // get the full momentum, including thermal motion
+                        u = batch_momentum ? XDim3{pux[ip], puy[ip], puz[ip]}
+                                           : inj_mom->getMomentum(pos.x, pos.y, 0._rt);
+                        const Real gamma_lab = std::sqrt( 1._rt+(u.x*u.x+u.y*u.y+u.z*u.z) );
+                        const Real betaz_lab = u.z/(gamma_lab);
+
+                        // At this point u and dens are the lab-frame quantities
+                        // => Perform Lorentz transform
+                        dens = gamma_boost * dens * ( 1.0_rt - beta_boost*betaz_lab );
+                        u.z = gamma_boost * ( u.z -beta_boost*gamma_lab );
                     }
-                    // Cut density if above threshold
-                    dens = amrex::min(dens, density_max);
-
-                    // get the full momentum, including thermal motion
-                    u = inj_mom->getMomentum(pos.x, pos.y, 0._rt);
-                    const Real gamma_lab = std::sqrt( 1._rt+(u.x*u.x+u.y*u.y+u.z*u.z) );
-                    const Real betaz_lab = u.z/(gamma_lab);
-
-                    // At this point u and dens are the lab-frame quantities
-                    // => Perform Lorentz transform
-                    dens = gamma_boost * dens * ( 1.0_rt - beta_boost*betaz_lab );
-                    u.z = gamma_boost * ( u.z -beta_boost*gamma_lab );
-                }
 
-                if (loc_do_field_ionization) {
-                    pi[ip] = loc_ionization_initial_level;
-                }
+                    if (loc_do_field_ionization) {
+                        pi[ip] = loc_ionization_initial_level;
+                    }
 
 #ifdef WARPX_QED
-                if(loc_has_quantum_sync){
-                    p_optical_depth_QSR[ip] = quantum_sync_get_opt();
-                }
+                    if(loc_has_quantum_sync){
+                        p_optical_depth_QSR[ip] = quantum_sync_get_opt();
+                    }
 
-                if(loc_has_breit_wheeler){
-                    p_optical_depth_BW[ip] = breit_wheeler_get_opt();
-                }
+                    if(loc_has_breit_wheeler){
+                        p_optical_depth_BW[ip] = breit_wheeler_get_opt();
+                    }
 #endif
 
-                u.x *= PhysConst::c;
-                u.y *= PhysConst::c;
-                u.z *= PhysConst::c;
+                    u.x *= PhysConst::c;
+                    u.y *= PhysConst::c;
+                    u.z *= PhysConst::c;
 
-                // Real weight = dens * scale_fac / (AMREX_D_TERM(fac, *fac, *fac));
-                Real weight = dens * scale_fac;
+                    // Real weight = dens * scale_fac / (AMREX_D_TERM(fac, *fac, *fac));
+                    Real weight = dens * scale_fac;
 #ifdef WARPX_DIM_RZ
-                if (radially_weighted) {
-                    weight *= 2._rt*MathConst::pi*xb;
-                } else {
-                    // This is not correct since it might shift the particle
-                    // out of the local grid
-                    pos.x = std::sqrt(xb*rmax);
-                    weight *= dx[0];
-                }
+                    if (radially_weighted) {
+                        weight *= 2._rt*MathConst::pi*xb;
+                    } else {
+                        // This is not correct since it might shift the particle
+                        // out of the local grid
+                        pos.x = std::sqrt(xb*rmax);
+                        weight *= dx[0];
+                    }
 #endif
-                pa[PIdx::w ][ip] = weight;
-                pa[PIdx::ux][ip] = u.x;
-                pa[PIdx::uy][ip] = u.y;
-                pa[PIdx::uz][ip] = u.z;
+                    pa[PIdx::w ][ip] = weight;
+                    pa[PIdx::ux][ip] = u.x;
+                    pa[PIdx::uy][ip] = u.y;
+                    pa[PIdx::uz][ip] = u.z;
 
 #if (AMREX_SPACEDIM == 3)
-                p.pos(0) = pos.x;
-                p.pos(1) = pos.y;
-                p.pos(2) = pos.z;
+                    p.pos(0) = pos.x;
+                    p.pos(1) = pos.y;
+                    p.pos(2) = pos.z;
 #elif (AMREX_SPACEDIM == 2)
 #ifdef WARPX_DIM_RZ
-                pa[PIdx::theta][ip] = theta;
+                    pa[PIdx::theta][ip] = theta;
 #endif
-                p.pos(0) = xb;
-                p.pos(1) = pos.z;
+                    p.pos(0) = xb;
+                    p.pos(1) = pos.z;
 #endif
+                }
+            });
+
+#ifndef AMREX_USE_GPU
+            if (pass == 0)
+            {
+                // Evaluate the parsers in batches, at the points of the valid particles
+                Gpu::DeviceVector<long> batch_index(n_batch);
+                long* const pindex = batch_index.dataPtr();
+                long n_eval = 0;
+                for (long ip = 0; ip < n_batch; ++ip) {
+                    if (pvalid[ip]) pindex[n_eval++] = ip;
+                }
+                if (batch_density) {
+                    inj_rho->getDensityBatch(n_eval,
+                        [=] AMREX_GPU_HOST_DEVICE (long i) noexcept
+                        {
+                            const long ip = pindex[i];
+                            return GpuArray<Real,3>{peval_x[ip], peval_y[ip], peval_z_rho[ip]};
+                        },
+                        [=] AMREX_GPU_HOST_DEVICE (long i, Real dens) noexcept
+                        {
+                            pdens[pindex[i]] = dens;
+                        });
+                }
+                if (batch_momentum) {
+                    const GpuArray<Real*,3> pu = {pux, puy, puz};
+                    inj_mom->getMomentumBatch(n_eval,
+                        [=] AMREX_GPU_HOST_DEVICE (long i) noexcept
+                        {
+                            const long ip = pindex[i];
+                            return GpuArray<Real,3>{peval_x[ip], peval_y[ip], peval_z_mom[ip]};
+                        },
+                        [=] AMREX_GPU_HOST_DEVICE (long i, int dir, Real u) noexcept
+                        {
+                            pu[dir][pindex[i]] = u;
+                        });
+                }
             }
-        });
+#endif
+        }
 
         if (cost && WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers)
         {
@@ -941,212 +1098,291 @@ PhysicalParticleContainer::Evolve (int lev,
 
     bool has_buffer = cEx || cjx;
 
+    // Gather, push and current deposition can be done in a single pass over
+    // the particles when no particle is split between the fine patch and the
+    // buffers, and when the deposition only needs the particle state after the push.
+    const bool do_fused = WarpX::do_fused_gather_push_deposit && !has_buffer
+        && !WarpX::do_electrostatic
+        && (WarpX::current_deposition_algo != CurrentDepositionAlgo::Vay)
+        && CanFuseGatherPushDeposit();
+
     if (WarpX::do_back_transformed_diagnostics && do_back_transformed_diagnostics)
     {
+        // When the old positions are reconstructed lazily, only the old momenta are stored
+        const bool lazy = LazyOldPositions();
         for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti)
         {
             const auto np = pti.numParticles();
             const auto t_lev = pti.GetLevel();
             const auto index = pti.GetPairIndex();
             tmp_particle_data.resize(finestLevel()+1);
-            for (int i = 0; i < TmpIdx::nattribs; ++i)
-                tmp_particle_data[t_lev][index][i].resize(np);
+            for (int i = 0; i < TmpIdx::nattribs; ++i) {
+                const bool is_position = (i == TmpIdx::xold || i == TmpIdx::yold || i == TmpIdx::zold);
+                tmp_particle_data[t_lev][index][i].resize((lazy && is_position) ? 0 : np);
+            }
         }
     }
 
+    // On CPU, the tiles can be colored so that the tiles of one color never
+    // deposit into the same cells: they are then processed concurrently, one
+    // color after the other, and deposit directly into jx, jy, jz and rho.
+    std::map<PairIndex,int> tile_color;
+    int ncolors = 1;
+#ifndef AMREX_USE_GPU
+    if (WarpX::do_colored_deposition && !has_buffer) {
+        const int reach = rho ? std::max(jx.nGrow(), rho->nGrow()) : jx.nGrow();
+        if (getTileColors(*this, lev, reach, tile_color)) ncolors = 1 << AMREX_SPACEDIM;
+    }
+#endif
+    deposit_in_place = (ncolors > 1);
+
+    for (int color = 0; color < ncolors; ++color)
+    {
 #ifdef _OPENMP
 #pragma omp parallel
 #endif
-    {
+        {
 #ifdef _OPENMP
-        int thread_num = omp_get_thread_num();
+            int thread_num = omp_get_thread_num();
 #else
-        int thread_num = 0;
+            int thread_num = 0;
 #endif
 
-        FArrayBox filtered_Ex, filtered_Ey, filtered_Ez;
-        FArrayBox filtered_Bx, filtered_By, filtered_Bz;
+            FArrayBox filtered_Ex, filtered_Ey, filtered_Ez;
+            FArrayBox filtered_Bx, filtered_By, filtered_Bz;
 
-        for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti)
-        {
-            if (cost && WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers)
+            for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti)
             {
-                amrex::Gpu::synchronize();
-            }
-            Real wt = amrex::second();
+                if (deposit_in_place && tile_color.at(pti.GetPairIndex()) != color) continue;
 
-            const Box& box = pti.validbox();
-
-            auto& attribs = pti.GetAttribs();
-
-            auto&  wp = attribs[PIdx::w];
-            auto& uxp = attribs[PIdx::ux];
-            auto& uyp = attribs[PIdx::uy];
-            auto& uzp = attribs[PIdx::uz];
+                if (cost && WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers)
+                {
+                    amrex::Gpu::synchronize();
+                }
+                Real wt = amrex::second();
 
-            const long np = pti.numParticles();
+                const Box& box = pti.validbox();
 
-            // Data on the grid
-            FArrayBox const* exfab = WarpX::fft_do_time_averaging ? &(Ex_avg[pti]) : &(Ex[pti]);
-            FArrayBox const* eyfab = WarpX::fft_do_time_averaging ? &(Ey_avg[pti]) : &(Ey[pti]);
-            FArrayBox const* ezfab = WarpX::fft_do_time_averaging ? &(Ez_avg[pti]) : &(Ez[pti]);
-            FArrayBox const* bxfab = WarpX::fft_do_time_averaging ? &(Bx_avg[pti]) : &(Bx[pti]);
-            FArrayBox const* byfab = WarpX::fft_do_time_averaging ? &(By_avg[pti]) : &(By[pti]);
-            FArrayBox const* bzfab = WarpX::fft_do_time_averaging ? &(Bz_avg[pti]) : &(Bz[pti]);
+                auto& attribs = pti.GetAttribs();
 
-            Elixir exeli, eyeli, ezeli, bxeli, byeli, bzeli;
+                auto&  wp = attribs[PIdx::w];
+                auto& uxp = attribs[PIdx::ux];
+                auto& uyp = attribs[PIdx::uy];
+                auto& uzp = attribs[PIdx::uz];
 
-            if (WarpX::use_fdtd_nci_corr)
-            {
-                // Filter arrays Ex[pti], store the result in
-                // filtered_Ex and update pointer exfab so that it
-                // points to filtered_Ex (and do the same for all
-                // components of E and B).
-                applyNCIFilter(lev, pti.tilebox(), exeli, eyeli, ezeli, bxeli, byeli, bzeli,
-                               filtered_Ex, filtered_Ey, filtered_Ez,
-                               filtered_Bx, filtered_By, filtered_Bz,
-                               Ex[pti], Ey[pti], Ez[pti], Bx[pti], By[pti], Bz[pti],
-                               exfab, eyfab, ezfab, bxfab, byfab, bzfab);
-            }
+                const long np = pti.numParticles();
 
-            // Determine which particles deposit/gather in the buffer, and
-            // which particles deposit/gather in the fine patch
-            long nfine_current = np;
-            long nfine_gather = np;
-            if (has_buffer && !do_not_push) {
-                // - Modify `nfine_current` and `nfine_gather` (in place)
-                //    so that they correspond to the number of particles
-                //    that deposit/gather in the fine patch respectively.
-                // - Reorder the particle arrays,
-                //    so that the `nfine_current`/`nfine_gather` first particles
-                //    deposit/gather in the fine patch
-                //    and (thus) the `np-nfine_current`/`np-nfine_gather` last particles
-                //    deposit/gather in the buffer
-                PartitionParticlesInBuffers( nfine_current, nfine_gather, np,
-                    pti, lev, current_masks, gather_masks, uxp, uyp, uzp, wp );
-            }
+                // Data on the grid
+                FArrayBox const* exfab = WarpX::fft_do_time_averaging ? &(Ex_avg[pti]) : &(Ex[pti]);
+                FArrayBox const* eyfab = WarpX::fft_do_time_averaging ? &(Ey_avg[pti]) : &(Ey[pti]);
+                FArrayBox const* ezfab = WarpX::fft_do_time_averaging ? &(Ez_avg[pti]) : &(Ez[pti]);
+                FArrayBox const* bxfab = WarpX::fft_do_time_averaging ? &(Bx_avg[pti]) : &(Bx[pti]);
+                FArrayBox const* byfab = WarpX::fft_do_time_averaging ? &(By_avg[pti]) : &(By[pti]);
+                FArrayBox const* bzfab = WarpX::fft_do_time_averaging ? &(Bz_avg[pti]) : &(Bz[pti]);
 
-            const long np_current = (cjx) ? nfine_current : np;
+                Elixir exeli, eyeli, ezeli, bxeli, byeli, bzeli;
 
-            if (rho) {
-                // Deposit charge before particle push, in component 0 of MultiFab rho.
-                int* AMREX_RESTRICT ion_lev;
-                if (do_field_ionization){
-                    ion_lev = pti.GetiAttribs(particle_icomps["ionization_level"]).dataPtr();
-                } else {
-                    ion_lev = nullptr;
-                }
-                DepositCharge(pti, wp, ion_lev, rho, 0, 0,
-                              np_current, thread_num, lev, lev);
-                if (has_buffer){
-                    DepositCharge(pti, wp, ion_lev, crho, 0, np_current,
-                                  np-np_current, thread_num, lev, lev-1);
+                if (WarpX::use_fdtd_nci_corr)
+                {
+                    // Filter arrays Ex[pti], store the result in
+                    // filtered_Ex and update pointer exfab so that it
+                    // points to filtered_Ex (and do the same for all
+                    // components of E and B).
+                    applyNCIFilter(lev, pti.tilebox(), exeli, eyeli, ezeli, bxeli, byeli, bzeli,
+                                   filtered_Ex, filtered_Ey, filtered_Ez,
+                                   filtered_Bx, filtered_By, filtered_Bz,
+                                   Ex[pti], Ey[pti], Ez[pti], Bx[pti], By[pti], Bz[pti],
+                                   exfab, eyfab, ezfab, bxfab, byfab, bzfab);
                 }
-            }
-
-            if (! do_not_push)
-            {
-                const long np_gather = (cEx) ? nfine_gather : np;
 
-                int e_is_nodal = Ex.is_nodal() and Ey.is_nodal() and Ez.is_nodal();
+                // Determine which particles deposit/gather in the buffer, and
+                // which particles deposit/gather in the fine patch
+                long nfine_current = np;
+                long nfine_gather = np;
+                if (has_buffer && !do_not_push) {
+                    // - Modify `nfine_current` and `nfine_gather` (in place)
+                    //    so that they correspond to the number of particles
+                    //    that deposit/gather in the fine patch respectively.
+                    // - Reorder the particle arrays,
+                    //    so that the `nfine_current`/`nfine_gather` first particles
+                    //    deposit/gather in the fine patch
+                    //    and (thus) the `np-nfine_current`/`np-nfine_gather` last particles
+                    //    deposit/gather in the buffer
+                    PartitionParticlesInBuffers( nfine_current, nfine_gather, np,
+                        pti, lev, current_masks, gather_masks, uxp, uyp, uzp, wp );
+                }
 
-                //
-                // Gather and push for particles not in the buffer
-                //
-                WARPX_PROFILE_VAR_START(blp_fg);
-                PushPX(pti, exfab, eyfab, ezfab,
-                       bxfab, byfab, bzfab,
-                       Ex.nGrow(), e_is_nodal,
-                       0, np_gather, lev, lev, dt, ScaleFields(false), a_dt_type);
+                const long np_current = (cjx) ? nfine_current : np;
 
-                if (np_gather < np)
+                // On CPU, heavy tiles are pushed and deposited in chunks,
+                // that can be shared among the threads
+#ifdef AMREX_USE_GPU
+                const bool split_tile = false;
+#else
+                const bool split_tile = (WarpX::tile_split_size > 0) && (np > WarpX::tile_split_size)
+                    && !has_buffer && !do_fused && !deposit_in_place && CanPushInChunks()
+                    && !WarpX::do_deterministic_deposition;
+#endif
+                if (split_tile)
                 {
-                    const IntVect& ref_ratio = WarpX::RefRatio(lev-1);
-                    const Box& cbox = amrex::coarsen(box,ref_ratio);
-
-                    // Data on the grid
-                    FArrayBox const* cexfab = &(*cEx)[pti];
-                    FArrayBox const* ceyfab = &(*cEy)[pti];
-                    FArrayBox const* cezfab = &(*cEz)[pti];
-                    FArrayBox const* cbxfab = &(*cBx)[pti];
-                    FArrayBox const* cbyfab = &(*cBy)[pti];
-                    FArrayBox const* cbzfab = &(*cBz)[pti];
-
-                    if (WarpX::use_fdtd_nci_corr)
-                    {
-                        // Filter arrays (*cEx)[pti], store the result in
-                        // filtered_Ex and update pointer cexfab so that it
-                        // points to filtered_Ex (and do the same for all
-                        // components of E and B)
-                        applyNCIFilter(lev-1, cbox, exeli, eyeli, ezeli, bxeli, byeli, bzeli,
-                                       filtered_Ex, filtered_Ey, filtered_Ez,
-                                       filtered_Bx, filtered_By, filtered_Bz,
-                                       (*cEx)[pti], (*cEy)[pti], (*cEz)[pti],
-                                       (*cBx)[pti], (*cBy)[pti], (*cBz)[pti],
-                                       cexfab, ceyfab, cezfab, cbxfab, cbyfab, cbzfab);
-                    }
-
-                    // Field gather and push for particles in gather buffers
-                    e_is_nodal = cEx->is_nodal() and cEy->is_nodal() and cEz->is_nodal();
-                    PushPX(pti, cexfab, ceyfab, cezfab,
-                           cbxfab, cbyfab, cbzfab,
-                           cEx->nGrow(), e_is_nodal,
-                           nfine_gather, np-nfine_gather,
-                           lev, lev-1, dt, ScaleFields(false), a_dt_type);
+                    const int e_is_nodal = Ex.is_nodal() and Ey.is_nodal() and Ez.is_nodal();
+                    // The chunks add their own time to the cost of the tile:
+                    // exclude the time of this call (during which this thread
+                    // may also execute the chunks of other tiles) from wt
+                    Real* const cost_tile =
+                        (cost && WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers)
+                        ? &(*cost)[pti.index()] : nullptr;
+                    const Real wt_chunks = amrex::second();
+                    WARPX_PROFILE_VAR_START(blp_fg);
+                    PushPXAndDepositInChunks(pti, exfab, eyfab, ezfab,
+                                             bxfab, byfab, bzfab,
+                                             Ex.nGrow(), e_is_nodal, &jx, &jy, &jz, rho,
+                                             lev, dt, a_dt_type, cost_tile);
+                    WARPX_PROFILE_VAR_STOP(blp_fg);
+                    wt += amrex::second() - wt_chunks;
                 }
 
-                WARPX_PROFILE_VAR_STOP(blp_fg);
-
-                //
-                // Current Deposition (only needed for electromagnetic solver)
-                //
-                if (!WarpX::do_electrostatic) {
+                if (rho && !split_tile) {
+                    // Deposit charge before particle push, in component 0 of MultiFab rho.
                     int* AMREX_RESTRICT ion_lev;
                     if (do_field_ionization){
                         ion_lev = pti.GetiAttribs(particle_icomps["ionization_level"]).dataPtr();
                     } else {
                         ion_lev = nullptr;
                     }
-                    // Deposit inside domains
-                    DepositCurrent(pti, wp, uxp, uyp, uzp, ion_lev, &jx, &jy, &jz,
-                                   0, np_current, thread_num,
-                                   lev, lev, dt);
+                    DepositCharge(pti, wp, ion_lev, rho, 0, 0,
+                                  np_current, thread_num, lev, lev);
                     if (has_buffer){
-                        // Deposit in buffers
-                        DepositCurrent(pti, wp, uxp, uyp, uzp, ion_lev, cjx, cjy, cjz,
-                                       np_current, np-np_current, thread_num,
-                                       lev, lev-1, dt);
+                        DepositCharge(pti, wp, ion_lev, crho, 0, np_current,
+                                      np-np_current, thread_num, lev, lev-1);
                     }
-                } // end of "if !do_electrostatic"
-            } // end of "if do_not_push"
+                }
 
-            if (rho) {
-                // Deposit charge after particle push, in component 1 of MultiFab rho.
-                // (Skipped for electrostatic solver, as this may lead to out-of-bounds)
-                if (!WarpX::do_electrostatic) {
+                if (! do_not_push && do_fused)
+                {
                     int* AMREX_RESTRICT ion_lev;
                     if (do_field_ionization){
                         ion_lev = pti.GetiAttribs(particle_icomps["ionization_level"]).dataPtr();
                     } else {
                         ion_lev = nullptr;
                     }
-                    DepositCharge(pti, wp, ion_lev, rho, 1, 0,
-                                  np_current, thread_num, lev, lev);
-                    if (has_buffer){
-                        DepositCharge(pti, wp, ion_lev, crho, 1, np_current,
-                                      np-np_current, thread_num, lev, lev-1);
+                    //
+                    // Gather, push and current deposition in one kernel
+                    //
+                    WARPX_PROFILE_VAR_START(blp_fg);
+                    PushPXAndDepositCurrent(pti, exfab, eyfab, ezfab,
+                                            bxfab, byfab, bzfab,
+                                            Ex.nGrow(), ion_lev, &jx, &jy, &jz,
+                                            thread_num, lev, dt, ScaleFields(false), a_dt_type);
+                    WARPX_PROFILE_VAR_STOP(blp_fg);
+                }
+                else if (! do_not_push && ! split_tile)
+                {
+                    const long np_gather = (cEx) ? nfine_gather : np;
+
+                    int e_is_nodal = Ex.is_nodal() and Ey.is_nodal() and Ez.is_nodal();
+
+                    //
+                    // Gather and push for particles not in the buffer
+                    //
+                    WARPX_PROFILE_VAR_START(blp_fg);
+                    PushPX(pti, exfab, eyfab, ezfab,
+                           bxfab, byfab, bzfab,
+                           Ex.nGrow(), e_is_nodal,
+                           0, np_gather, lev, lev, dt, ScaleFields(false), a_dt_type);
+
+                    if (np_gather < np)
+                    {
+                        const IntVect& ref_ratio = WarpX::RefRatio(lev-1);
+                        const Box& cbox = amrex::coarsen(box,ref_ratio);
+
+                        // Data on the grid
+                        FArrayBox const* cexfab = &(*cEx)[pti];
+                        FArrayBox const* ceyfab = &(*cEy)[pti];
+                        FArrayBox const* cezfab = &(*cEz)[pti];
+                        FArrayBox const* cbxfab = &(*cBx)[pti];
+                        FArrayBox const* cbyfab = &(*cBy)[pti];
+                        FArrayBox const* cbzfab = &(*cBz)[pti];
+
+                        if (WarpX::use_fdtd_nci_corr)
+                        {
+                            // Filter arrays (*cEx)[pti], store the result in
+                            // filtered_Ex and update pointer cexfab so that it
+                            // points to filtered_Ex (and do the same for all
+                            // components of E and B)
+                            applyNCIFilter(lev-1, cbox, exeli, eyeli, ezeli, bxeli, byeli, bzeli,
+                                           filtered_Ex, filtered_Ey, filtered_Ez,
+                                           filtered_Bx, filtered_By, filtered_Bz,
+                                           (*cEx)[pti], (*cEy)[pti], (*cEz)[pti],
+                                           (*cBx)[pti], (*cBy)[pti], (*cBz)[pti],
+                                           cexfab, ceyfab, cezfab, cbxfab, cbyfab, cbzfab);
+                        }
+
+                        // Field gather and push for particles in gather buffers
+                        e_is_nodal = cEx->is_nodal() and cEy->is_nodal() and cEz->is_nodal();
+                        PushPX(pti, cexfab, ceyfab, cezfab,
+                               cbxfab, cbyfab, cbzfab,
+                               cEx->nGrow(), e_is_nodal,
+                               nfine_gather, np-nfine_gather,
+                               lev, lev-1, dt, ScaleFields(false), a_dt_type);
+                    }
+
+                    WARPX_PROFILE_VAR_STOP(blp_fg);
+
+                    //
+                    // Current Deposition (only needed for electromagnetic solver)
+                    //
+                    if (!WarpX::do_electrostatic) {
+                        int* AMREX_RESTRICT ion_lev;
+                        if (do_field_ionization){
+                            ion_lev = pti.GetiAttribs(particle_icomps["ionization_level"]).dataPtr();
+                        } else {
+                            ion_lev = nullptr;
+                        }
+                        // Deposit inside domains
+                        DepositCurrent(pti, wp, uxp, uyp, uzp, ion_lev, &jx, &jy, &jz,
+                                       0, np_current, thread_num,
+                                       lev, lev, dt);
+                        if (has_buffer){
+                            // Deposit in buffers
+                            DepositCurrent(pti, wp, uxp, uyp, uzp, ion_lev, cjx, cjy, cjz,
+                                           np_current, np-np_current, thread_num,
+                                           lev, lev-1, dt);
+                        }
+                    } // end of "if !do_electrostatic"
+                } // end of "if do_not_push"
+
+                if (rho && !split_tile) {
+                    // Deposit charge after particle push, in component 1 of MultiFab rho.
+                    // (Skipped for electrostatic solver, as this may lead to out-of-bounds)
+                    if (!WarpX::do_electrostatic) {
+                        int* AMREX_RESTRICT ion_lev;
+                        if (do_field_ionization){
+                            ion_lev = pti.GetiAttribs(particle_icomps["ionization_level"]).dataPtr();
+                        } else {
+                            ion_lev = nullptr;
+                        }
+                        DepositCharge(pti, wp, ion_lev, rho, 1, 0,
+                                      np_current, thread_num, lev, lev);
+                        if (has_buffer){
+                            DepositCharge(pti, wp, ion_lev, crho, 1, np_current,
+                                          np-np_current, thread_num, lev, lev-1);
+                        }
                     }
                 }
-            }
 
-            if (cost && WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers)
-            {
-                amrex::Gpu::synchronize();
-                wt = amrex::second() - wt;
-                amrex::HostDevice::Atomic::Add( &(*cost)[pti.index()], wt);
+                if (cost && WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers)
+                {
+                    amrex::Gpu::synchronize();
+                    wt = amrex::second() - wt;
+                    amrex::HostDevice::Atomic::Add( &(*cost)[pti.index()], wt);
+                }
             }
         }
     }
+    deposit_in_place = false;
+    ReduceDepositionBuffers();
+
     // Split particles at the end of the timestep.
     // When subcycling is ON, the splitting is done on the last call to
     // PhysicalParticleContainer::Evolve on the finest level, i.e., at the
@@ -1407,6 +1643,12 @@ PhysicalParticleContainer::PushP (int lev, Real dt,
 
     const std::array<amrex::Real,3>& dx = WarpX::CellSize(std::max(lev,0));
 
+    // The old positions of the particles cannot be reconstructed from their
+    // momenta once these are modified: store them now
+    const bool store_old_positions = WarpX::do_back_transformed_diagnostics
+        && do_back_transformed_diagnostics && LazyOldPositions();
+    const Real push_dt = WarpX::GetInstance().getdt(lev);
+
 #ifdef _OPENMP
 #pragma omp parallel
 #endif
@@ -1418,6 +1660,8 @@ PhysicalParticleContainer::PushP (int lev, Real dt,
 
             const long np = pti.numParticles();
 
+            if (store_old_positions) StoreOldPositions(pti, lev, push_dt);
+
             // Data on the grid
             const FArrayBox& exfab = Ex[pti];
             const FArrayBox& eyfab = Ey[pti];
@@ -1588,6 +1832,10 @@ PhysicalParticleContainer::GetParticleSlice (
             // Note that the destructor for WarpXParIter is synchronized.
             amrex::Gpu::ManagedDeviceVector<int> FlagForPartCopy;
             amrex::Gpu::ManagedDeviceVector<int> IndexForPartCopy;
+            // Same for the indices and the old attributes of the particles
+            // that are selected, when they are reconstructed lazily
+            amrex::Gpu::ManagedDeviceVector<int> SelectedParticles;
+            TmpParticleTile SelectedOldAttribs;
             for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti)
             {
                 const Box& box = pti.validbox();
@@ -1599,25 +1847,41 @@ PhysicalParticleContainer::GetParticleSlice (
                 const auto GetPosition = GetParticlePosition(pti);
 
                 auto& attribs = pti.GetAttribs();
-                Real* const AMREX_RESTRICT wpnew = attribs[PIdx::w].dataPtr();
-                Real* const AMREX_RESTRICT uxpnew = attribs[PIdx::ux].dataPtr();
-                Real* const AMREX_RESTRICT uypnew = attribs[PIdx::uy].dataPtr();
-                Real* const AMREX_RESTRICT uzpnew = attribs[PIdx::uz].dataPtr();
-
-                Real* const AMREX_RESTRICT
-                  xpold = tmp_particle_data[lev][index][TmpIdx::xold].dataPtr();
-                Real* const AMREX_RESTRICT
-                  ypold = tmp_particle_data[lev][index][TmpIdx::yold].dataPtr();
-                Real* const AMREX_RESTRICT
-                  zpold = tmp_particle_data[lev][index][TmpIdx::zold].dataPtr();
-                Real* const AMREX_RESTRICT
-                  uxpold = tmp_particle_data[lev][index][TmpIdx::uxold].dataPtr();
-                Real* const AMREX_RESTRICT
-                  uypold = tmp_particle_data[lev][index][TmpIdx::uyold].dataPtr();
-                Real* const AMREX_RESTRICT
-                  uzpold = tmp_particle_data[lev][index][TmpIdx::uzold].dataPtr();
+                ParticleReal* const AMREX_RESTRICT wpnew = attribs[PIdx::w].dataPtr();
+                ParticleReal* const AMREX_RESTRICT uxpnew = attribs[PIdx::ux].dataPtr();
+                ParticleReal* const AMREX_RESTRICT uypnew = attribs[PIdx::uy].dataPtr();
+                ParticleReal* const AMREX_RESTRICT uzpnew = attribs[PIdx::uz].dataPtr();
+
+                // Old attributes of the particles that are checked: either all
+                // the particles of the tile, copied during the push, or only
+                // those selected by their position (Sel[i] is then the index of
+                // the i-th selected particle), reconstructed here
+                long np = pti.numParticles();
+                const int* AMREX_RESTRICT Sel = nullptr;
+                TmpParticleTile* old_attribs;
+                if (LazyOldPositions()) {
+                    np = GetOldParticleAttribs(pti, lev, z_min - PhysConst::c*dt,
+                                               z_max + PhysConst::c*dt, dt,
+                                               SelectedParticles, SelectedOldAttribs);
+                    if (np == 0) continue;
+                    Sel = SelectedParticles.dataPtr();
+                    old_attribs = &SelectedOldAttribs;
+                } else {
+                    old_attribs = &(tmp_particle_data[lev][index]);
+                }
 
-                const long np = pti.numParticles();
+                ParticleReal* const AMREX_RESTRICT
+                  xpold = (*old_attribs)[TmpIdx::xold].dataPtr();
+                ParticleReal* const AMREX_RESTRICT
+                  ypold = (*old_attribs)[TmpIdx::yold].dataPtr();
+                ParticleReal* const AMREX_RESTRICT
+                  zpold = (*old_attribs)[TmpIdx::zold].dataPtr();
+                ParticleReal* const AMREX_RESTRICT
+                  uxpold = (*old_attribs)[TmpIdx::uxold].dataPtr();
+                ParticleReal* const AMREX_RESTRICT
+                  uypold = (*old_attribs)[TmpIdx::uyold].dataPtr();
+                ParticleReal* const AMREX_RESTRICT
+                  uzpold = (*old_attribs)[TmpIdx::uzold].dataPtr();
 
                 Real uzfrm = -WarpX::gamma_boost*WarpX::beta_boost*PhysConst::c;
                 Real inv_c2 = 1.0/PhysConst::c/PhysConst::c;
@@ -1633,7 +1897,7 @@ PhysicalParticleContainer::GetParticleSlice (
                 [=] AMREX_GPU_DEVICE(int i)
                 {
                     ParticleReal xp, yp, zp;
-                    GetPosition(i, xp, yp, zp);
+                    GetPosition(Sel ? Sel[i] : i, xp, yp, zp);
                     Flag[i] = 0;
                     if ( (((zp >= z_new) && (zpold[i] <= z_old)) ||
                           ((zp <= z_new) && (zpold[i] >= z_old))) )
@@ -1656,19 +1920,19 @@ PhysicalParticleContainer::GetParticleSlice (
                 amrex::Real betaboost = WarpX::beta_boost;
                 amrex::Real Phys_c = PhysConst::c;
 
-                Real* const AMREX_RESTRICT diag_wp =
+                ParticleReal* const AMREX_RESTRICT diag_wp =
                 diagnostic_particles[lev][index].GetRealData(DiagIdx::w).data();
-                Real* const AMREX_RESTRICT diag_xp =
+                ParticleReal* const AMREX_RESTRICT diag_xp =
                 diagnostic_particles[lev][index].GetRealData(DiagIdx::x).data();
-                Real* const AMREX_RESTRICT diag_yp =
+                ParticleReal* const AMREX_RESTRICT diag_yp =
                 diagnostic_particles[lev][index].GetRealData(DiagIdx::y).data();
-                Real* const AMREX_RESTRICT diag_zp =
+                ParticleReal* const AMREX_RESTRICT diag_zp =
                 diagnostic_particles[lev][index].GetRealData(DiagIdx::z).data();
-                Real* const AMREX_RESTRICT diag_uxp =
+                ParticleReal* const AMREX_RESTRICT diag_uxp =
                 diagnostic_particles[lev][index].GetRealData(DiagIdx::ux).data();
-                Real* const AMREX_RESTRICT diag_uyp =
+                ParticleReal* const AMREX_RESTRICT diag_uyp =
                 diagnostic_particles[lev][index].GetRealData(DiagIdx::uy).data();
-                Real* const AMREX_RESTRICT diag_uzp =
+                ParticleReal* const AMREX_RESTRICT diag_uzp =
                 diagnostic_particles[lev][index].GetRealData(DiagIdx::uz).data();
 
                 // Copy particle data to diagnostic particle array on the GPU
@@ -1676,18 +1940,21 @@ PhysicalParticleContainer::GetParticleSlice (
                 amrex::ParallelFor(np,
                 [=] AMREX_GPU_DEVICE(int i)
                 {
-                    ParticleReal xp_new, yp_new, zp_new;
-                    GetPosition(i, xp_new, yp_new, zp_new);
                     if (Flag[i] == 1)
                     {
+                         // Index of the particle in the tile
+                         const int ip = Sel ? Sel[i] : i;
+                         ParticleReal xp_new, yp_new, zp_new;
+                         GetPosition(ip, xp_new, yp_new, zp_new);
+
                          // Lorentz Transform particles to lab-frame
                          const Real gamma_new_p = std::sqrt(1.0 + inv_c2*
-                                                  (uxpnew[i]*uxpnew[i]
-                                                 + uypnew[i]*uypnew[i]
-                                                 + uzpnew[i]*uzpnew[i]));
+                                                  (uxpnew[ip]*uxpnew[ip]
+                                                 + uypnew[ip]*uypnew[ip]
+                                                 + uzpnew[ip]*uzpnew[ip]));
                          const Real t_new_p = gammaboost*t_boost - uzfrm*zp_new*inv_c2;
                          const Real z_new_p = gammaboost*(zp_new + betaboost*Phys_c*t_boost);
-                         const Real uz_new_p = gammaboost*uzpnew[i] - gamma_new_p*uzfrm;
+                         const Real uz_new_p = gammaboost*uzpnew[ip] - gamma_new_p*uzfrm;
 
                          const Real gamma_old_p = std::sqrt(1.0 + inv_c2*
                                                   (uxpold[i]*uxpold[i]
@@ -1711,14 +1978,14 @@ PhysicalParticleContainer::GetParticleSlice (
                          const Real zp = z_old_p*weight_old  + z_new_p*weight_new;
 
                          const Real uxp = uxpold[i]*weight_old
-                                        + uxpnew[i]*weight_new;
+                                        + uxpnew[ip]*weight_new;
                          const Real uyp = uypold[i]*weight_old
-                                        + uypnew[i]*weight_new;
+                                        + uypnew[ip]*weight_new;
                          const Real uzp = uz_old_p*weight_old
                                         + uz_new_p  *weight_new;
 
                          const int loc = IndexLocation[i];
-                         diag_wp[loc] = wpnew[i];
+                         diag_wp[loc] = wpnew[ip];
                          diag_xp[loc] = xp;
                          diag_yp[loc] = yp;
                          diag_zp[loc] = zp;
@@ -1732,6 +1999,151 @@ PhysicalParticleContainer::GetParticleSlice (
     }
 }
 
+/* \brief Select the particles of a tile between z_min and z_max, and get
+ * their position and momentum before the last push.
+ *
+ * The old momenta are copied during the push. The old positions are either
+ * those stored by StoreOldPositions (when the momenta changed after the
+ * push), or reconstructed from the new position and momentum. The particles
+ * created after the push (e.g. by QED processes) have no old attributes and
+ * are not selected.
+ */
+long
+PhysicalParticleContainer::GetOldParticleAttribs (WarpXParIter& pti, int lev,
+                                                  Real z_min, Real z_max, Real dt,
+                                                  Gpu::ManagedDeviceVector<int>& selected,
+                                                  TmpParticleTile& old_attribs)
+{
+    const auto index = pti.GetPairIndex();
+    TmpParticleTile& tmp = tmp_particle_data[lev][index];
+    const long np = std::min(static_cast<long>(pti.numParticles()),
+                             static_cast<long>(tmp[TmpIdx::uxold].size()));
+    if (np == 0) {
+        selected.resize(0);
+        for (int i = 0; i < TmpIdx::nattribs; ++i) old_attribs[i].resize(0);
+        return 0;
+    }
+    const auto GetPosition = GetParticlePosition(pti);
+
+    // Select the particles from their position (flag and compact)
+    Gpu::ManagedDeviceVector<int> flag(np);
+    Gpu::ManagedDeviceVector<int> sel_index(np);
+    int* const AMREX_RESTRICT pflag = flag.dataPtr();
+    int* const AMREX_RESTRICT pindex = sel_index.dataPtr();
+    amrex::ParallelFor(np,
+    [=] AMREX_GPU_DEVICE(long i)
+    {
+        ParticleReal xp, yp, zp;
+        GetPosition(i, xp, yp, zp);
+        pflag[i] = (zp >= z_min) && (zp <= z_max);
+    });
+    amrex::Gpu::exclusive_scan(pflag, pflag+np, pindex);
+    const long nsel = pindex[np-1] + pflag[np-1];
+
+    selected.resize(nsel);
+    for (int i = 0; i < TmpIdx::nattribs; ++i) old_attribs[i].resize(nsel);
+    if (nsel == 0) return 0;
+
+    int* const AMREX_RESTRICT psel = selected.dataPtr();
+    amrex::ParallelFor(np,
+    [=] AMREX_GPU_DEVICE(long i)
+    {
+        if (pflag[i]) psel[pindex[i]] = i;
+    });
+
+    auto& attribs = pti.GetAttribs();
+    const ParticleReal* const AMREX_RESTRICT ux = attribs[PIdx::ux].dataPtr();
+    const ParticleReal* const AMREX_RESTRICT uy = attribs[PIdx::uy].dataPtr();
+    const ParticleReal* const AMREX_RESTRICT uz = attribs[PIdx::uz].dataPtr();
+
+    // Positions stored before the momenta were modified, if any
+    const bool stored = (static_cast<long>(tmp[TmpIdx::xold].size()) >= np);
+    const ParticleReal* const AMREX_RESTRICT xstored = stored ? tmp[TmpIdx::xold].dataPtr() : nullptr;
+    const ParticleReal* const AMREX_RESTRICT ystored = stored ? tmp[TmpIdx::yold].dataPtr() : nullptr;
+    const ParticleReal* const AMREX_RESTRICT zstored = stored ? tmp[TmpIdx::zold].dataPtr() : nullptr;
+    const ParticleReal* const AMREX_RESTRICT uxtmp = tmp[TmpIdx::uxold].dataPtr();
+    const ParticleReal* const AMREX_RESTRICT uytmp = tmp[TmpIdx::uyold].dataPtr();
+    const ParticleReal* const AMREX_RESTRICT uztmp = tmp[TmpIdx::uzold].dataPtr();
+
+    ParticleReal* const AMREX_RESTRICT xpold = old_attribs[TmpIdx::xold].dataPtr();
+    ParticleReal* const AMREX_RESTRICT ypold = old_attribs[TmpIdx::yold].dataPtr();
+    ParticleReal* const AMREX_RESTRICT zpold = old_attribs[TmpIdx::zold].dataPtr();
+    ParticleReal* const AMREX_RESTRICT uxpold = old_attribs[TmpIdx::uxold].dataPtr();
+    ParticleReal* const AMREX_RESTRICT uypold = old_attribs[TmpIdx::uyold].dataPtr();
+    ParticleReal* const AMREX_RESTRICT uzpold = old_attribs[TmpIdx::uzold].dataPtr();
+
+    const bool is_photon = AmIA<PhysicalSpecies::photon>();
+    const auto t_do_not_push = do_not_push;
+
+    amrex::ParallelFor(nsel,
+    [=] AMREX_GPU_DEVICE(long j)
+    {
+        const int i = psel[j];
+        ParticleReal xp, yp, zp;
+        if (xstored) {
+            xp = xstored[i];
+            yp = ystored[i];
+            zp = zstored[i];
+        } else {
+            GetPosition(i, xp, yp, zp);
+            if (!t_do_not_push) getOldPosition(xp, yp, zp, ux[i], uy[i], uz[i], is_photon, dt);
+        }
+
+        xpold[j] = xp;
+        ypold[j] = yp;
+        zpold[j] = zp;
+        uxpold[j] = uxtmp[i];
+        uypold[j] = uytmp[i];
+        uzpold[j] = uztmp[i];
+    });
+    Gpu::synchronize();
+
+    return nsel;
+}
+
+void
+PhysicalParticleContainer::StoreOldPositions (WarpXParIter& pti, int lev, Real dt)
+{
+    if (lev >= static_cast<int>(tmp_particle_data.size())) return;
+    auto it = tmp_particle_data[lev].find(pti.GetPairIndex());
+    if (it == tmp_particle_data[lev].end()) return;
+    TmpParticleTile& tmp = it->second;
+    const long np = std::min(static_cast<long>(pti.numParticles()),
+                             static_cast<long>(tmp[TmpIdx::uxold].size()));
+    // Nothing to do if the positions are already stored
+    if (np == 0 || static_cast<long>(tmp[TmpIdx::xold].size()) >= np) return;
+    tmp[TmpIdx::xold].resize(np);
+    tmp[TmpIdx::yold].resize(np);
+    tmp[TmpIdx::zold].resize(np);
+
+    const auto GetPosition = GetParticlePosition(pti);
+    auto& attribs = pti.GetAttribs();
+    const ParticleReal* const AMREX_RESTRICT ux = attribs[PIdx::ux].dataPtr();
+    const ParticleReal* const AMREX_RESTRICT uy = attribs[PIdx::uy].dataPtr();
+    const ParticleReal* const AMREX_RESTRICT uz = attribs[PIdx::uz].dataPtr();
+    ParticleReal* const AMREX_RESTRICT xpold = tmp[TmpIdx::xold].dataPtr();
+    ParticleReal* const AMREX_RESTRICT ypold = tmp[TmpIdx::yold].dataPtr();
+    ParticleReal* const AMREX_RESTRICT zpold = tmp[TmpIdx::zold].dataPtr();
+
+    const bool is_photon = AmIA<PhysicalSpecies::photon>();
+    amrex::ParallelFor(np,
+    [=] AMREX_GPU_DEVICE(long i)
+    {
+        ParticleReal xp, yp, zp;
+        GetPosition(i, xp, yp, zp);
+        getOldPosition(xp, yp, zp, ux[i], uy[i], uz[i], is_photon, dt);
+        xpold[i] = xp;
+        ypold[i] = yp;
+        zpold[i] = zp;
+    });
+}
+
+bool
+PhysicalParticleContainer::LazyOldPositions () const
+{
+    return WarpX::do_lazy_back_transformed_particles && CanReconstructOldPositions();
+}
+
 /* \brief Inject particles during the simulation
  * \param injection_box: domain where particles should be injected.
  */
@@ -1743,6 +2155,73 @@ PhysicalParticleContainer::ContinuousInjection (const RealBox& injection_box)
     AddPlasma(lev, injection_box);
 }
 
+/* \brief On CPU, compute the fields on the particles before the push loop:
+ * - the fields gathered by the vectorized gather. It is skipped for tiles
+ *   with few particles per cell, for which the copy of the fields into the
+ *   interleaved buffer costs more than it saves;
+ * - the external fields, when they are given by parsers: the parsers are
+ *   then evaluated in batches over the particles, rather than one particle
+ *   at a time.
+ * When both are computed, the external fields are added to the gathered ones.
+ */
+const amrex::ParticleReal*
+PhysicalParticleContainer::ComputeFieldsOnParticles (const WarpXParIter& pti,
+                                                     long offset, long np_to_push,
+                                                     amrex::FArrayBox const * exfab,
+                                                     amrex::FArrayBox const * eyfab,
+                                                     amrex::FArrayBox const * ezfab,
+                                                     amrex::FArrayBox const * bxfab,
+                                                     amrex::FArrayBox const * byfab,
+                                                     amrex::FArrayBox const * bzfab,
+                                                     const amrex::Box& box,
+                                                     const amrex::GpuArray<amrex::Real, 3>& dx,
+                                                     const amrex::GpuArray<amrex::Real, 3>& xyzmin,
+                                                     bool& has_gathered, bool& has_external)
+{
+    has_gathered = false;
+    has_external = false;
+#ifdef AMREX_USE_GPU
+    amrex::ignore_unused(pti, offset, np_to_push, exfab, eyfab, ezfab, bxfab, byfab, bzfab,
+                         box, dx, xyzmin);
+    return nullptr;
+#else
+    const auto getExternalE = GetExternalEField(pti, offset);
+    const auto getExternalB = GetExternalBField(pti, offset);
+    has_gathered = WarpX::do_vectorized_gather && !do_not_gather &&
+        np_to_push >= WarpX::vectorized_gather_min_ppc*box.numPts();
+    has_external = (getExternalE.m_type == Parser || getExternalB.m_type == Parser);
+    if (!has_gathered && !has_external) return nullptr;
+
+#ifdef _OPENMP
+    const int thread_num = omp_get_thread_num();
+#else
+    const int thread_num = 0;
+#endif
+    auto& fields = local_particle_fields[thread_num];
+    if (static_cast<long>(fields.size()) < 6*np_to_push) {
+        fields.resize(6*np_to_push);
+    }
+    amrex::ParticleReal* const p = fields.data();
+    std::fill(p, p + 6*np_to_push, 0._rt);
+    if (has_gathered) {
+        WARPX_PROFILE("PPC::PushPX::VectorizedGather");
+        doVectorizedGatherShapeN(GetParticlePosition(pti, offset),
+                                 p, p + np_to_push, p + 2*np_to_push,
+                                 p + 3*np_to_push, p + 4*np_to_push, p + 5*np_to_push,
+                                 exfab, eyfab, ezfab, bxfab, byfab, bzfab,
+                                 local_interleaved_fields[thread_num], box,
+                                 np_to_push, dx, xyzmin, amrex::lbound(box),
+                                 WarpX::n_rz_azimuthal_modes,
+                                 WarpX::nox, WarpX::galerkin_interpolation);
+    }
+    if (has_external) {
+        getExternalE.addToArrays(np_to_push, p, p + np_to_push, p + 2*np_to_push);
+        getExternalB.addToArrays(np_to_push, p + 3*np_to_push, p + 4*np_to_push, p + 5*np_to_push);
+    }
+    return p;
+#endif
+}
+
 /* \brief Perform the field gather and particle push operations in one fused kernel
  *
  */
@@ -1767,9 +2246,67 @@ PhysicalParticleContainer::PushPX (WarpXParIter& pti,
     // If no particles, do not do anything
     if (np_to_push == 0) return;
 
-    // Get cell size on gather_lev
-    const std::array<Real,3>& dx = WarpX::CellSize(std::max(gather_lev,0));
+    const Box box = getGatherBox(pti, ngE, lev, gather_lev);
+    const auto gatherFields = getFieldGatherFunctor(exfab, eyfab, ezfab, bxfab, byfab, bzfab,
+                                                    box, lev, gather_lev);
+    const auto pushParticle = getPushFunctor(pti, offset, dt, scaleFields, a_dt_type);
+
+    const auto getPosition = GetParticlePosition(pti, offset);
+    const auto getExternalE = GetExternalEField(pti, offset);
+    const auto getExternalB = GetExternalBField(pti, offset);
+
+    // Fields on the particles computed before the push loop (on CPU)
+    bool has_gathered = false;
+    bool has_external = false;
+    const amrex::ParticleReal* AMREX_RESTRICT particle_fields =
+        ComputeFieldsOnParticles(pti, offset, np_to_push,
+                                 exfab, eyfab, ezfab, bxfab, byfab, bzfab,
+                                 box, gatherFields.m_dx, gatherFields.m_xyzmin,
+                                 has_gathered, has_external);
 
+    amrex::ParallelFor( np_to_push, [=] AMREX_GPU_DEVICE (long ip)
+    {
+        amrex::ParticleReal xp, yp, zp;
+        getPosition(ip, xp, yp, zp);
+
+        amrex::ParticleReal Exp = 0._rt, Eyp = 0._rt, Ezp = 0._rt;
+        amrex::ParticleReal Bxp = 0._rt, Byp = 0._rt, Bzp = 0._rt;
+
+        if (has_gathered) {
+            // Gathered fields, plus the external fields if they were computed
+            Exp = particle_fields[ip];
+            Eyp = particle_fields[ip + np_to_push];
+            Ezp = particle_fields[ip + 2*np_to_push];
+            Bxp = particle_fields[ip + 3*np_to_push];
+            Byp = particle_fields[ip + 4*np_to_push];
+            Bzp = particle_fields[ip + 5*np_to_push];
+        } else {
+            // first gather E and B to the particle positions
+            gatherFields(xp, yp, zp, Exp, Eyp, Ezp, Bxp, Byp, Bzp);
+            if (has_external) {
+                Exp += particle_fields[ip];
+                Eyp += particle_fields[ip + np_to_push];
+                Ezp += particle_fields[ip + 2*np_to_push];
+                Bxp += particle_fields[ip + 3*np_to_push];
+                Byp += particle_fields[ip + 4*np_to_push];
+                Bzp += particle_fields[ip + 5*np_to_push];
+            }
+        }
+        if (!has_external) {
+            // Externally applied E-field in Cartesian co-ordinates
+            getExternalE(ip, Exp, Eyp, Ezp);
+            // Externally applied B-field in Cartesian co-ordinates
+            getExternalB(ip, Bxp, Byp, Bzp);
+        }
+
+        pushParticle(ip, xp, yp, zp, Exp, Eyp, Ezp, Bxp, Byp, Bzp);
+    });
+}
+
+Box
+PhysicalParticleContainer::getGatherBox (const WarpXParIter& pti, int ngE,
+                                         int lev, int gather_lev) const
+{
     // Get box from which field is gathered.
     // If not gathering from the finest level, the box is coarsened.
     Box box;
@@ -1782,12 +2319,20 @@ PhysicalParticleContainer::PushPX (WarpXParIter& pti,
 
     // Add guard cells to the box.
     box.grow(ngE);
+    return box;
+}
 
-    const auto getPosition = GetParticlePosition(pti, offset);
-          auto setPosition = SetParticlePosition(pti, offset);
-
-    const auto getExternalE = GetExternalEField(pti, offset);
-    const auto getExternalB = GetExternalBField(pti, offset);
+FieldGatherFunctor
+PhysicalParticleContainer::getFieldGatherFunctor (amrex::FArrayBox const * exfab,
+                                                  amrex::FArrayBox const * eyfab,
+                                                  amrex::FArrayBox const * ezfab,
+                                                  amrex::FArrayBox const * bxfab,
+                                                  amrex::FArrayBox const * byfab,
+                                                  amrex::FArrayBox const * bzfab,
+                                                  const Box& box, int lev, int gather_lev) const
+{
+    // Get cell size on gather_lev
+    const std::array<Real,3>& dx = WarpX::CellSize(std::max(gather_lev,0));
 
     // Lower corner of tile box physical domain (take into account Galilean shift)
     Real cur_time = WarpX::GetInstance().gett_new(lev);
@@ -1796,113 +2341,238 @@ PhysicalParticleContainer::PushPX (WarpXParIter& pti,
     amrex::Array<amrex::Real,3> galilean_shift = { v_galilean[0]*time_shift, v_galilean[1]*time_shift, v_galilean[2]*time_shift };
     const std::array<Real, 3>& xyzmin = WarpX::LowerCorner(box, galilean_shift, gather_lev);
 
-    const Dim3 lo = lbound(box);
+    return FieldGatherFunctor(exfab, eyfab, ezfab, bxfab, byfab, bzfab, box, dx, xyzmin,
+                              WarpX::n_rz_azimuthal_modes, WarpX::nox,
+                              WarpX::galerkin_interpolation, do_not_gather);
+}
 
-    bool galerkin_interpolation = WarpX::galerkin_interpolation;
-    int nox = WarpX::nox;
-    int n_rz_azimuthal_modes = WarpX::n_rz_azimuthal_modes;
+ParticlePushFunctor
+PhysicalParticleContainer::getPushFunctor (WarpXParIter& pti, long offset, amrex::Real dt,
+                                           ScaleFields scaleFields, DtType a_dt_type)
+{
+    ParticlePushFunctor push(pti, tmp_particle_data, offset, scaleFields);
 
-    amrex::GpuArray<amrex::Real, 3> dx_arr = {dx[0], dx[1], dx[2]};
-    amrex::GpuArray<amrex::Real, 3> xyzmin_arr = {xyzmin[0], xyzmin[1], xyzmin[2]};
-
-    amrex::Array4<const amrex::Real> const& ex_arr = exfab->array();
-    amrex::Array4<const amrex::Real> const& ey_arr = eyfab->array();
-    amrex::Array4<const amrex::Real> const& ez_arr = ezfab->array();
-    amrex::Array4<const amrex::Real> const& bx_arr = bxfab->array();
-    amrex::Array4<const amrex::Real> const& by_arr = byfab->array();
-    amrex::Array4<const amrex::Real> const& bz_arr = bzfab->array();
-
-    amrex::IndexType const ex_type = exfab->box().ixType();
-    amrex::IndexType const ey_type = eyfab->box().ixType();
-    amrex::IndexType const ez_type = ezfab->box().ixType();
-    amrex::IndexType const bx_type = bxfab->box().ixType();
-    amrex::IndexType const by_type = byfab->box().ixType();
-    amrex::IndexType const bz_type = bzfab->box().ixType();
+    if (do_field_ionization) {
+        push.m_ion_lev = pti.GetiAttribs(particle_icomps["ionization_level"]).dataPtr() + offset;
+    }
 
-    auto& attribs = pti.GetAttribs();
-    ParticleReal* const AMREX_RESTRICT ux = attribs[PIdx::ux].dataPtr();
-    ParticleReal* const AMREX_RESTRICT uy = attribs[PIdx::uy].dataPtr();
-    ParticleReal* const AMREX_RESTRICT uz = attribs[PIdx::uz].dataPtr();
+    push.m_q = this->charge;
+    push.m_m = this->mass;
+    push.m_dt = dt;
+    push.m_pusher_algo = WarpX::particle_pusher_algo;
+    push.m_do_crr = do_classical_radiation_reaction;
+    push.m_do_copy = (WarpX::do_back_transformed_diagnostics &&
+                      do_back_transformed_diagnostics &&
+                      (a_dt_type!=DtType::SecondHalf));
+#ifdef WARPX_QED
+    push.m_do_sync = m_do_qed_quantum_sync;
+    if (push.m_do_sync) push.m_t_chi_max = m_shr_p_qs_engine->get_ref_ctrl().chi_part_min;
+
+    if (has_quantum_sync()) {
+        push.m_evolve_opt = m_shr_p_qs_engine->build_evolve_functor();
+        push.m_optical_depth_QSR = pti.GetAttribs(particle_comps["optical_depth_QSR"]).dataPtr() + offset;
+    }
+#endif
+    return push;
+}
+
+/* \brief Push the particles of a tile and deposit their charge and current
+ * in chunks of WarpX::tile_split_size particles. Each chunk is an OpenMP task:
+ * it is executed either by the thread that owns the tile (while it waits for
+ * the chunks to complete), or by any thread that has no more tiles to process.
+ * Each chunk deposits in the local buffers of the thread that executes it,
+ * which are then atomically added to the global arrays. Since the chunks
+ * are not executed by the calling thread only, each chunk adds the time it
+ * took to the cost of the tile.
+ */
+void
+PhysicalParticleContainer::PushPXAndDepositInChunks (WarpXParIter& pti,
+                                                     amrex::FArrayBox const * exfab,
+                                                     amrex::FArrayBox const * eyfab,
+                                                     amrex::FArrayBox const * ezfab,
+                                                     amrex::FArrayBox const * bxfab,
+                                                     amrex::FArrayBox const * byfab,
+                                                     amrex::FArrayBox const * bzfab,
+                                                     const int ngE, const int e_is_nodal,
+                                                     amrex::MultiFab* jx,
+                                                     amrex::MultiFab* jy,
+                                                     amrex::MultiFab* jz,
+                                                     amrex::MultiFab* rho,
+                                                     int lev, amrex::Real dt,
+                                                     DtType a_dt_type,
+                                                     amrex::Real* cost)
+{
+    const long np = pti.numParticles();
+    const long chunk_size = WarpX::tile_split_size;
 
-    auto copyAttribs = CopyParticleAttribs(pti, tmp_particle_data, offset);
-    int do_copy = (WarpX::do_back_transformed_diagnostics &&
-                          do_back_transformed_diagnostics &&
-                   (a_dt_type!=DtType::SecondHalf));
+    // The tasks refer to the iterator through a pointer
+    // (the iterator itself cannot be copied)
+    WarpXParIter* const ppti = &pti;
 
     int* AMREX_RESTRICT ion_lev = nullptr;
     if (do_field_ionization) {
         ion_lev = pti.GetiAttribs(particle_icomps["ionization_level"]).dataPtr();
     }
 
-    // Loop over the particles and update their momentum
-    const amrex::Real q = this->charge;
-    const amrex::Real m = this-> mass;
+    for (long offset = 0; offset < np; offset += chunk_size)
+    {
+        const long np_chunk = std::min(chunk_size, np - offset);
+#ifdef _OPENMP
+#pragma omp task firstprivate(offset, np_chunk)
+#endif
+        {
+            Real wt = amrex::second();
+#ifdef _OPENMP
+            const int thread_num = omp_get_thread_num();
+#else
+            const int thread_num = 0;
+#endif
+            auto& attribs = ppti->GetAttribs();
+            auto&  wp = attribs[PIdx::w];
+            auto& uxp = attribs[PIdx::ux];
+            auto& uyp = attribs[PIdx::uy];
+            auto& uzp = attribs[PIdx::uz];
+            // The deposition functions expect the ionization level
+            // of the first particle to deposit
+            const int* const ion_lev_chunk = ion_lev ? ion_lev + offset : nullptr;
 
-    const auto pusher_algo = WarpX::particle_pusher_algo;
-    const auto do_crr = do_classical_radiation_reaction;
-#ifdef WARPX_QED
-    const auto do_sync = m_do_qed_quantum_sync;
-    amrex::Real t_chi_max = 0.0;
-    if (do_sync) t_chi_max = m_shr_p_qs_engine->get_ref_ctrl().chi_part_min;
-
-    QuantumSynchrotronEvolveOpticalDepth evolve_opt;
-    amrex::ParticleReal* AMREX_RESTRICT p_optical_depth_QSR = nullptr;
-    const bool local_has_quantum_sync = has_quantum_sync();
-    if (local_has_quantum_sync) {
-        evolve_opt = m_shr_p_qs_engine->build_evolve_functor();
-        p_optical_depth_QSR = pti.GetAttribs(particle_comps["optical_depth_QSR"]).dataPtr();
+            if (rho) {
+                // Deposit charge before particle push, in component 0 of MultiFab rho.
+                DepositCharge(*ppti, wp, ion_lev_chunk, rho, 0, offset, np_chunk,
+                              thread_num, lev, lev);
+            }
+            if (! do_not_push) {
+                PushPX(*ppti, exfab, eyfab, ezfab, bxfab, byfab, bzfab,
+                       ngE, e_is_nodal, offset, np_chunk, lev, lev, dt,
+                       ScaleFields(false), a_dt_type);
+                if (!WarpX::do_electrostatic) {
+                    DepositCurrent(*ppti, wp, uxp, uyp, uzp, ion_lev_chunk, jx, jy, jz,
+                                   offset, np_chunk, thread_num, lev, lev, dt);
+                }
+            }
+            if (rho && !WarpX::do_electrostatic) {
+                // Deposit charge after particle push, in component 1 of MultiFab rho.
+                DepositCharge(*ppti, wp, ion_lev_chunk, rho, 1, offset, np_chunk,
+                              thread_num, lev, lev);
+            }
+
+            if (cost)
+            {
+                wt = amrex::second() - wt;
+                amrex::HostDevice::Atomic::Add(cost, wt);
+            }
+        }
     }
+#ifdef _OPENMP
+#pragma omp taskwait
 #endif
+}
+
+/* \brief Perform the field gather, particle push and current deposition
+ * in one fused kernel. Each particle is read once, gathers its fields, is
+ * pushed in registers and deposits its current right away, instead of being
+ * re-read from memory by separate gather and deposition kernels. For this
+ * reason, the external fields given by parsers are evaluated per particle,
+ * and the vectorized gather is not used.
+ */
+void
+PhysicalParticleContainer::PushPXAndDepositCurrent (WarpXParIter& pti,
+                                                    amrex::FArrayBox const * exfab,
+                                                    amrex::FArrayBox const * eyfab,
+                                                    amrex::FArrayBox const * ezfab,
+                                                    amrex::FArrayBox const * bxfab,
+                                                    amrex::FArrayBox const * byfab,
+                                                    amrex::FArrayBox const * bzfab,
+                                                    const int ngE,
+                                                    const int * const ion_lev,
+                                                    amrex::MultiFab* jx,
+                                                    amrex::MultiFab* jy,
+                                                    amrex::MultiFab* jz,
+                                                    int thread_num, int lev,
+                                                    amrex::Real dt, ScaleFields scaleFields,
+                                                    DtType a_dt_type)
+{
+    const long np_to_push = pti.numParticles();
+    // If no particles, do not do anything
+    if (np_to_push == 0) return;
+
+    WARPX_PROFILE_VAR_NS("PPC::GatherPushAndDeposit", blp_fused);
+
+    const Box gather_box = getGatherBox(pti, ngE, lev, lev);
+    const auto gatherFields = getFieldGatherFunctor(exfab, eyfab, ezfab, bxfab, byfab, bzfab,
+                                                    gather_box, lev, lev);
+    const auto pushParticle = getPushFunctor(pti, 0, dt, scaleFields, a_dt_type);
+
+    const auto getPosition = GetParticlePosition(pti);
+    const auto getExternalE = GetExternalEField(pti);
+    const auto getExternalB = GetExternalBField(pti);
+
+    // The particles are not pushed yet: they can move by one more cell
+    // before depositing
+    const CurrentDepositionTile tile = PrepareCurrentDeposition(
+        pti, jx, jy, jz, 0, np_to_push, thread_num, lev, lev, dt, 1);
+    Array4<Real> const& jx_arr = tile.jx_fab->array();
+    Array4<Real> const& jy_arr = tile.jy_fab->array();
+    Array4<Real> const& jz_arr = tile.jz_fab->array();
+    amrex::IntVect const jx_type = jx->ixType().toIntVect();
+    amrex::IntVect const jy_type = jy->ixType().toIntVect();
+    amrex::IntVect const jz_type = jz->ixType().toIntVect();
+    const std::array<Real,3>& dx = WarpX::CellSize(std::max(lev,0));
+    amrex::GpuArray<amrex::Real, 3> dx_arr = {dx[0], dx[1], dx[2]};
+    amrex::GpuArray<amrex::Real, 3> depos_xyzmin_arr = {tile.xyzmin[0], tile.xyzmin[1], tile.xyzmin[2]};
+    const Dim3 depos_lo = tile.lo;
+
+    const bool do_esirkepov =
+        (WarpX::current_deposition_algo == CurrentDepositionAlgo::Esirkepov);
+    int nox = WarpX::nox;
+    int n_rz_azimuthal_modes = WarpX::n_rz_azimuthal_modes;
 
-    const auto t_do_not_gather = do_not_gather;
+    const ParticleReal* const AMREX_RESTRICT wp = pti.GetAttribs(PIdx::w).dataPtr();
+    // The momenta after the push are read through the push functor
+    ParticleReal* const ux = pushParticle.m_ux;
+    ParticleReal* const uy = pushParticle.m_uy;
+    ParticleReal* const uz = pushParticle.m_uz;
+    const int* const ion_lev = pushParticle.m_ion_lev;
 
+    const amrex::Real q = this->charge;
+    const auto t_do_not_deposit = do_not_deposit;
+
+    WARPX_PROFILE_VAR_START(blp_fused);
     amrex::ParallelFor( np_to_push, [=] AMREX_GPU_DEVICE (long ip)
     {
         amrex::ParticleReal xp, yp, zp;
         getPosition(ip, xp, yp, zp);
 
+        // Gather E and B to the particle position, and add the external fields
         amrex::ParticleReal Exp = 0._rt, Eyp = 0._rt, Ezp = 0._rt;
         amrex::ParticleReal Bxp = 0._rt, Byp = 0._rt, Bzp = 0._rt;
-
-        if(!t_do_not_gather){
-            // first gather E and B to the particle positions
-            doGatherShapeN(xp, yp, zp, Exp, Eyp, Ezp, Bxp, Byp, Bzp,
-                           ex_arr, ey_arr, ez_arr, bx_arr, by_arr, bz_arr,
-                           ex_type, ey_type, ez_type, bx_type, by_type, bz_type,
-                           dx_arr, xyzmin_arr, lo, n_rz_azimuthal_modes,
-                           nox, galerkin_interpolation);
-        }
-        // Externally applied E-field in Cartesian co-ordinates
+        gatherFields(xp, yp, zp, Exp, Eyp, Ezp, Bxp, Byp, Bzp);
         getExternalE(ip, Exp, Eyp, Ezp);
-        // Externally applied B-field in Cartesian co-ordinates
         getExternalB(ip, Bxp, Byp, Bzp);
 
-        scaleFields(xp, yp, zp, Exp, Eyp, Ezp, Bxp, Byp, Bzp);
+        pushParticle(ip, xp, yp, zp, Exp, Eyp, Ezp, Bxp, Byp, Bzp);
 
-#ifdef WARPX_QED
-    if (local_has_quantum_sync) {
-        const ParticleReal px = m * ux[ip];
-        const ParticleReal py = m * uy[ip];
-        const ParticleReal pz = m * uz[ip];
-
-        bool has_event_happened = evolve_opt(px, py, pz,
-                                             Exp, Eyp, Ezp,
-                                             Bxp, Byp, Bzp,
-                                             dt, p_optical_depth_QSR[ip]);
-    }
-#endif
+        if (t_do_not_deposit) return;
 
-        doParticlePush(getPosition, setPosition, copyAttribs, ip,
-                       ux[ip+offset], uy[ip+offset], uz[ip+offset],
-                       Exp, Eyp, Ezp, Bxp, Byp, Bzp,
-                       ion_lev ? ion_lev[ip] : 0,
-                       m, q, pusher_algo, do_crr, do_copy,
-#ifdef WARPX_QED
-                       do_sync,
-                       t_chi_max,
-#endif
-                       dt);
+        // Deposit the current of the pushed particle
+        amrex::Real wq = q*wp[ip];
+        if (ion_lev) wq *= ion_lev[ip];
+        getPosition(ip, xp, yp, zp);
+        if (do_esirkepov) {
+            doEsirkepovDepositionShapeN(xp, yp, zp, wq, ux[ip], uy[ip], uz[ip],
+                                        jx_arr, jy_arr, jz_arr,
+                                        dt, dx_arr, depos_xyzmin_arr, depos_lo,
+                                        n_rz_azimuthal_modes, nox);
+        } else {
+            doDepositionShapeN(xp, yp, zp, wq, ux[ip], uy[ip], uz[ip],
+                               jx_arr, jy_arr, jz_arr, jx_type, jy_type, jz_type,
+                               dt, dx_arr, depos_xyzmin_arr, depos_lo,
+                               n_rz_azimuthal_modes, nox);
+        }
     });
+    WARPX_PROFILE_VAR_STOP(blp_fused);
+
+    if (!do_not_deposit) FinishCurrentDeposition(pti, jx, jy, jz, thread_num, tile);
 }
 
 void
@@ -1952,6 +2622,33 @@ PhysicalParticleContainer::InitIonizationModule ()
             * std::pow(2*std::pow((Uion/UH),3./2)*Ea,2*n_eff - 1);
         adk_exp_prefactor[i] = -2./3 * std::pow( Uion/UH,3./2) * Ea;
     }
+
+    // Optionally, tabulate the ADK rate of each ionization level, in order
+    // to avoid the pow and exp calls of each particle at each step.
+    // The table is log-spaced in |E|, from E_max/200 (below which the rate
+    // is negligible, since it includes a factor exp(-200)) to
+    // E_max = -adk_exp_prefactor (above which the exact formula is used).
+    pp.query("do_adk_table", do_adk_table);
+    if (do_adk_table) {
+        pp.query("adk_table_size", adk_table_size);
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(adk_table_size >= 2,
+            species_name + ".adk_table_size must be at least 2");
+        const Real log_range = std::log(200._rt);
+        adk_table.resize(ion_atomic_number*adk_table_size);
+        adk_table_log_emin.resize(ion_atomic_number);
+        adk_table_inv_dlog.resize(ion_atomic_number);
+        for (int i=0; i<ion_atomic_number; ++i){
+            const Real log_emax = std::log(-adk_exp_prefactor[i]);
+            const Real dlog = log_range/(adk_table_size - 1);
+            adk_table_log_emin[i] = log_emax - log_range;
+            adk_table_inv_dlog[i] = 1._rt/dlog;
+            for (int k=0; k<adk_table_size; ++k){
+                const Real E = std::exp(adk_table_log_emin[i] + k*dlog);
+                adk_table[i*adk_table_size + k] = adk_prefactor[i] *
+                    std::pow(E, adk_power[i]) * std::exp(adk_exp_prefactor[i]/E);
+            }
+        }
+    }
 }
 
 IonizationFilterFunc
@@ -1973,6 +2670,10 @@ PhysicalParticleContainer::getIonizationFunc (const WarpXParIter& pti,
                                 adk_prefactor.dataPtr(),
                                 adk_exp_prefactor.dataPtr(),
                                 adk_power.dataPtr(),
+                                do_adk_table ? adk_table.dataPtr() : nullptr,
+                                adk_table_log_emin.dataPtr(),
+                                adk_table_inv_dlog.dataPtr(),
+                                adk_table_size,
                                 particle_icomps["ionization_level"],
                                 ion_atomic_number);
 }
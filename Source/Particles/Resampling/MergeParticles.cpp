@@ -0,0 +1,197 @@
+/* Copyright 2020 The WarpX Community
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+#include "MergeParticles.H"
+#include "Particles/PhysicalParticleContainer.H"
+#include "Utils/WarpXConst.H"
+#include "WarpX.H"
+
+#include <AMReX_DenseBins.H>
+#include <AMReX_Gpu.H>
+
+#include <cmath>
+#include <limits>
+
+
+using namespace amrex;
+
+/* \brief Merge the particles of the cells that contain more than
+ *        `resampling_target_ppc` particles, conserving the total weight,
+ *        momentum and energy of each cell
+ *
+ *  The particles of each cell are found with the cached cell bins, shared
+ *  with the collisions (see getCellBins; the particle arrays are not reordered). In each cell that
+ *  contains more than `resampling_target_ppc` particles, the particles are
+ *  distributed into `resampling_target_ppc/2` groups of similar momentum norm.
+ *  Each group of 3 or more particles is replaced by 2 particles located at
+ *  the weighted mean position of the group, each carrying half of its weight,
+ *  with momenta that conserve the momentum and energy of the group
+ *  (see getMergedMomenta). The two first particles of the group are reused
+ *  for this purpose (so that they keep their other attributes, e.g. optical
+ *  depths), and the other particles are invalidated (they are removed by the
+ *  next Redistribute).
+ *  After merging, each of these cells thus contains at most
+ *  `resampling_target_ppc` particles.
+ *  Note that the merged particles are moved to a new position, without
+ *  depositing the corresponding current: the charge density on the grid
+ *  changes (within the cell) while E does not, so that Gauss's law
+ *  div(E) = rho/epsilon_0, which a charge-conserving current deposition
+ *  (Esirkepov) otherwise preserves, is no longer satisfied. This error is
+ *  not corrected, unless divergence cleaning is used (warpx.do_dive_cleaning).
+ *
+ * \param lev refinement level
+ */
+void
+PhysicalParticleContainer::MergeParticles (int lev)
+{
+    WARPX_PROFILE("PhysicalParticleContainer::MergeParticles");
+
+    const int target_ppc = resampling_target_ppc;
+    const int ngroups = target_ppc/2;
+    const bool is_photon = AmIA<PhysicalSpecies::photon>();
+
+#ifdef _OPENMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+    for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti)
+    {
+        auto& ptile = ParticlesAt(lev, pti);
+        const int np = ptile.numParticles();
+        if (np <= target_ppc) continue;
+
+        // Find the particles that are in each cell of this tile
+        auto& bins = getCellBins(lev, pti);
+        const int n_cells = bins.numBins();
+        auto const* const AMREX_RESTRICT indices = bins.permutationPtr();
+        auto const* const AMREX_RESTRICT cell_offsets = bins.offsetsPtr();
+
+        ParticleType* const AMREX_RESTRICT pstruct = ptile.GetArrayOfStructs()().data();
+        auto& soa = ptile.GetStructOfArrays();
+        ParticleReal* const AMREX_RESTRICT wp = soa.GetRealData(PIdx::w).data();
+        ParticleReal* const AMREX_RESTRICT uxp = soa.GetRealData(PIdx::ux).data();
+        ParticleReal* const AMREX_RESTRICT uyp = soa.GetRealData(PIdx::uy).data();
+        ParticleReal* const AMREX_RESTRICT uzp = soa.GetRealData(PIdx::uz).data();
+#if (defined WARPX_DIM_RZ)
+        ParticleReal* const AMREX_RESTRICT thetap = soa.GetRealData(PIdx::theta).data();
+#endif
+        Gpu::DeviceVector<int> group(np);
+        int* const AMREX_RESTRICT pgroup = group.dataPtr();
+
+        // Loop over cells
+        amrex::ParallelFor( n_cells,
+            [=] AMREX_GPU_DEVICE (int i_cell) noexcept
+            {
+                const auto cell_start = cell_offsets[i_cell];
+                const auto cell_stop = cell_offsets[i_cell+1];
+                const int n = static_cast<int>(cell_stop - cell_start);
+                if (n <= target_ppc) return;
+
+                // Range of momentum norms in this cell
+                ParticleReal u_min = std::numeric_limits<ParticleReal>::max();
+                ParticleReal u_max = 0._rt;
+                for (auto k = cell_start; k < cell_stop; ++k) {
+                    const auto ip = indices[k];
+                    const ParticleReal u = std::sqrt(uxp[ip]*uxp[ip] + uyp[ip]*uyp[ip] + uzp[ip]*uzp[ip]);
+                    u_min = amrex::min(u_min, u);
+                    u_max = amrex::max(u_max, u);
+                }
+                // Group of each particle: bins of momentum norm, or consecutive
+                // particles if they all have the same norm. The groups are
+                // stored before any particle of the cell is modified.
+                for (auto k = cell_start; k < cell_stop; ++k) {
+                    const auto ip = indices[k];
+                    int g;
+                    if (u_max > u_min) {
+                        const ParticleReal u = std::sqrt(uxp[ip]*uxp[ip] + uyp[ip]*uyp[ip] + uzp[ip]*uzp[ip]);
+                        g = static_cast<int>((u - u_min)/(u_max - u_min)*ngroups);
+                    } else {
+                        g = (static_cast<int>(k - cell_start)*ngroups)/n;
+                    }
+                    pgroup[ip] = amrex::min(g, ngroups-1);
+                }
+
+                for (int g = 0; g < ngroups; ++g) {
+                    // Total weight, weighted position, momentum and energy of the group
+                    int count = 0;
+                    int ia = -1;
+                    int ib = -1;
+                    ParticleReal w_tot = 0._rt;
+                    ParticleReal pos_tot[AMREX_SPACEDIM] = {AMREX_D_DECL(0._rt, 0._rt, 0._rt)};
+#if (defined WARPX_DIM_RZ)
+                    ParticleReal cos_tot = 0._rt;
+                    ParticleReal sin_tot = 0._rt;
+#endif
+                    ParticleReal ux_tot = 0._rt, uy_tot = 0._rt, uz_tot = 0._rt;
+                    // Energy: sum of w*(gamma-1) for massive particles,
+                    // and of w*|u| for photons
+                    ParticleReal e_tot = 0._rt;
+                    for (auto k = cell_start; k < cell_stop; ++k) {
+                        const int ip = static_cast<int>(indices[k]);
+                        if (pgroup[ip] != g) continue;
+                        if (count == 0) ia = ip;
+                        if (count == 1) ib = ip;
+                        ++count;
+                        const ParticleReal w = wp[ip];
+                        w_tot += w;
+                        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                            pos_tot[idim] += w*pstruct[ip].pos(idim);
+                        }
+#if (defined WARPX_DIM_RZ)
+                        cos_tot += w*std::cos(thetap[ip]);
+                        sin_tot += w*std::sin(thetap[ip]);
+#endif
+                        ux_tot += w*uxp[ip];
+                        uy_tot += w*uyp[ip];
+                        uz_tot += w*uzp[ip];
+                        const ParticleReal u2 = uxp[ip]*uxp[ip] + uyp[ip]*uyp[ip] + uzp[ip]*uzp[ip];
+                        if (is_photon) {
+                            e_tot += w*std::sqrt(u2);
+                        } else {
+                            // gamma-1, written so as to avoid cancellations
+                            constexpr ParticleReal inv_c2 = 1._rt/(PhysConst::c*PhysConst::c);
+                            e_tot += w*u2*inv_c2/(std::sqrt(1._rt + u2*inv_c2) + 1._rt);
+                        }
+                    }
+                    // Merging fewer than 3 particles would not reduce their number
+                    if (count < 3 || w_tot <= 0._rt) continue;
+
+                    // Momentum norm of the new particles, that conserves the energy
+                    ParticleReal u_norm;
+                    if (is_photon) {
+                        u_norm = e_tot/w_tot;
+                    } else {
+                        const ParticleReal gm1 = e_tot/w_tot;
+                        u_norm = PhysConst::c*std::sqrt(gm1*(gm1 + 2._rt));
+                    }
+                    ParticleReal ux_a, uy_a, uz_a, ux_b, uy_b, uz_b;
+                    getMergedMomenta(ux_tot/w_tot, uy_tot/w_tot, uz_tot/w_tot, u_norm,
+                                     ux_a, uy_a, uz_a, ux_b, uy_b, uz_b);
+
+                    // Reuse the two first particles of the group,
+                    // and invalidate the others
+                    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                        pstruct[ia].pos(idim) = pos_tot[idim]/w_tot;
+                        pstruct[ib].pos(idim) = pos_tot[idim]/w_tot;
+                    }
+#if (defined WARPX_DIM_RZ)
+                    thetap[ia] = std::atan2(sin_tot, cos_tot);
+                    thetap[ib] = thetap[ia];
+#endif
+                    wp[ia] = 0.5_rt*w_tot;
+                    wp[ib] = 0.5_rt*w_tot;
+                    uxp[ia] = ux_a; uyp[ia] = uy_a; uzp[ia] = uz_a;
+                    uxp[ib] = ux_b; uyp[ib] = uy_b; uzp[ib] = uz_b;
+                    for (auto k = cell_start; k < cell_stop; ++k) {
+                        const int ip = static_cast<int>(indices[k]);
+                        if (ip == ia || ip == ib) continue;
+                        if (pgroup[ip] == g) pstruct[ip].id() = -1;
+                    }
+                }
+            }
+        );
+        Gpu::synchronize();
+    }
+}
@@ -0,0 +1,156 @@
+/* Copyright 2020 The WarpX Community
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+#include "SpaceFillingCurve.H"
+#include "Particles/WarpXParticleContainer.H"
+#include "WarpX.H"
+
+#include <AMReX_Gpu.H>
+
+
+using namespace amrex;
+
+namespace {
+
+    /** \brief Move the elements of `data` from the positions `src` to the
+     *  positions `dst`, leaving all other elements untouched
+     *
+     * \param[inout] data array (of one particle component) to be modified
+     * \param[in] src positions of the elements to be moved
+     * \param[in] dst new positions of these elements
+     * \param[in] n number of elements to be moved
+     */
+    template <typename T>
+    void moveElements (T* const AMREX_RESTRICT data,
+                       int const* const AMREX_RESTRICT src,
+                       int const* const AMREX_RESTRICT dst,
+                       int const n)
+    {
+        Gpu::DeviceVector<T> tmp(n);
+        T* const AMREX_RESTRICT ptmp = tmp.dataPtr();
+        amrex::ParallelFor( n, [=] AMREX_GPU_DEVICE (int j) noexcept
+        {
+            ptmp[j] = data[src[j]];
+        });
+        amrex::ParallelFor( n, [=] AMREX_GPU_DEVICE (int j) noexcept
+        {
+            data[dst[j]] = ptmp[j];
+        });
+        Gpu::synchronize();
+    }
+
+}
+
+/* \brief Group the particles of each tile by bin, by moving only
+ *        the particles that are not already in the range of their bin
+ *
+ *  The bins are the same as in the full sort (`SortParticlesByBin`):
+ *  boxes of `bin_size` cells within each tile, ordered according to
+ *  `sort_order` (see GetParticleBin). Within a tile, the bins are
+ *  assigned contiguous, consecutive ranges of the particle arrays, whose
+ *  size is the number of particles in each bin. A particle that already lies
+ *  within the range of its bin is left in place; the other particles
+ *  (typically those that crossed a bin boundary since the last step, or
+ *  that were shifted by a change in the number of particles of a previous
+ *  bin) are moved into the free slots of the range of their bin.
+ *  The cost of the data movement is thus proportional to the number of
+ *  particles that changed bin, instead of the total number of particles.
+ *  The order of the particles within a bin is not preserved.
+ *
+ * \param bin_size size of the bins, in number of cells
+ * \param sort_order order of the bins (see ParticleSortOrder)
+ */
+void
+WarpXParticleContainer::SortParticlesByBinIncremental (IntVect bin_size, int sort_order)
+{
+    WARPX_PROFILE("WarpXParticleContainer::SortParticlesByBinIncremental");
+
+    for (int lev = 0; lev <= finestLevel(); ++lev)
+    {
+#ifdef _OPENMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+        for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti)
+        {
+            auto& ptile = ParticlesAt(lev, pti);
+            const int np = ptile.numParticles();
+            if (np == 0) continue;
+
+            ParticleType* const AMREX_RESTRICT pstruct = ptile.GetArrayOfStructs()().data();
+
+            // Bins of this tile
+            const GetParticleBin get_bin(pti.tilebox(), Geom(lev), bin_size, sort_order);
+            const int nbins = get_bin.numBins();
+
+            // - Find the bin of each particle, and count the particles in each bin
+            Gpu::DeviceVector<int> bin(np);
+            Gpu::DeviceVector<int> bin_count(nbins+1, 0);
+            Gpu::DeviceVector<int> bin_start(nbins+1);
+            int* const AMREX_RESTRICT pbin = bin.dataPtr();
+            int* const AMREX_RESTRICT pcount = bin_count.dataPtr();
+            amrex::ParallelFor( np, [=] AMREX_GPU_DEVICE (int i) noexcept
+            {
+                const int b = get_bin(pstruct[i]);
+                pbin[i] = b;
+                amrex::Gpu::Atomic::Add(&pcount[b], 1);
+            });
+            // - Range of the particle arrays that is assigned to each bin
+            Gpu::exclusive_scan(bin_count.begin(), bin_count.end(), bin_start.begin());
+            int const* const AMREX_RESTRICT pstart = bin_start.dataPtr();
+
+            // - Flag the particles that are outside of the range of their bin
+            Gpu::DeviceVector<int> misplaced(np+1, 0);
+            Gpu::DeviceVector<int> misplaced_offset(np+1);
+            int* const AMREX_RESTRICT pmisplaced = misplaced.dataPtr();
+            amrex::ParallelFor( np, [=] AMREX_GPU_DEVICE (int i) noexcept
+            {
+                const int b = pbin[i];
+                pmisplaced[i] = (i < pstart[b] || i >= pstart[b+1]);
+            });
+            Gpu::exclusive_scan(misplaced.begin(), misplaced.end(), misplaced_offset.begin());
+            int n_misplaced;
+#ifdef AMREX_USE_GPU
+            Gpu::dtoh_memcpy(&n_misplaced, misplaced_offset.dataPtr()+np, sizeof(int));
+#else
+            n_misplaced = misplaced_offset[np];
+#endif
+            // Nothing to do if the tile is already grouped by bin
+            if (n_misplaced == 0) continue;
+
+            // - List the positions of the misplaced particles
+            Gpu::DeviceVector<int> src(n_misplaced);
+            Gpu::DeviceVector<int> dst(n_misplaced);
+            int* const AMREX_RESTRICT psrc = src.dataPtr();
+            int* const AMREX_RESTRICT pdst = dst.dataPtr();
+            int const* const AMREX_RESTRICT poffset = misplaced_offset.dataPtr();
+            amrex::ParallelFor( np, [=] AMREX_GPU_DEVICE (int i) noexcept
+            {
+                if (pmisplaced[i]) psrc[poffset[i]] = i;
+            });
+            // - The slots freed in the range of a bin are exactly as many as the
+            //   misplaced particles of this bin: assign one of them to each particle.
+            //   The misplaced slots of bin b are numbered from poffset[pstart[b]].
+            Gpu::DeviceVector<int> bin_rank(nbins, 0);
+            int* const AMREX_RESTRICT prank = bin_rank.dataPtr();
+            amrex::ParallelFor( n_misplaced, [=] AMREX_GPU_DEVICE (int j) noexcept
+            {
+                const int b = pbin[psrc[j]];
+                const int k = amrex::Gpu::Atomic::Add(&prank[b], 1);
+                pdst[j] = psrc[poffset[pstart[b]] + k];
+            });
+
+            // - Move the misplaced particles (all components)
+            moveElements(pstruct, psrc, pdst, n_misplaced);
+            auto& soa = ptile.GetStructOfArrays();
+            for (int comp = 0; comp < NumRealComps(); ++comp) {
+                moveElements(soa.GetRealData(comp).dataPtr(), psrc, pdst, n_misplaced);
+            }
+            for (int comp = 0; comp < NumIntComps(); ++comp) {
+                moveElements(soa.GetIntData(comp).dataPtr(), psrc, pdst, n_misplaced);
+            }
+        }
+    }
+}
@@ -0,0 +1,224 @@
+/* Copyright 2020 The WarpX Community
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+#include "SpaceFillingCurve.H"
+#include "Particles/WarpXParticleContainer.H"
+#include "WarpX.H"
+
+#include <AMReX_Gpu.H>
+
+#include <array>
+#include <utility>
+
+
+using namespace amrex;
+
+namespace {
+
+    /** \brief Fill `perm` with the indices that sort `keys` in increasing order
+     *
+     * On CPU, this is a stable least-significant-digit radix sort, with 8 bits
+     * per pass. On GPU, the keys are sorted in a single counting pass over
+     * the whole key range (the order of equal keys is then arbitrary).
+     *
+     * \param[in] keys keys to be sorted, in [0, 2^nbits)
+     * \param[out] perm permutation that sorts the keys
+     * \param[in] np number of keys
+     * \param[in] nbits number of significant bits of the keys
+     */
+    void radixSortPermutation (Gpu::DeviceVector<int> const& keys,
+                               Gpu::DeviceVector<int>& perm,
+                               int const np, int const nbits)
+    {
+        perm.resize(np);
+        int* const AMREX_RESTRICT pperm = perm.dataPtr();
+#ifdef AMREX_USE_GPU
+        const int nkeys = 1 << nbits;
+        int const* const AMREX_RESTRICT pkeys = keys.dataPtr();
+        Gpu::DeviceVector<int> count(nkeys+1, 0);
+        Gpu::DeviceVector<int> offset(nkeys+1);
+        int* const AMREX_RESTRICT pcount = count.dataPtr();
+        amrex::ParallelFor( np, [=] AMREX_GPU_DEVICE (int i) noexcept
+        {
+            amrex::Gpu::Atomic::Add(&pcount[pkeys[i]], 1);
+        });
+        Gpu::exclusive_scan(count.begin(), count.end(), offset.begin());
+        int* const AMREX_RESTRICT poffset = offset.dataPtr();
+        amrex::ParallelFor( np, [=] AMREX_GPU_DEVICE (int i) noexcept
+        {
+            pperm[amrex::Gpu::Atomic::Add(&poffset[pkeys[i]], 1)] = i;
+        });
+        Gpu::synchronize();
+#else
+        constexpr int radix_bits = 8;
+        constexpr int radix = 1 << radix_bits;
+        Gpu::DeviceVector<int> keys_a(np);
+        Gpu::DeviceVector<int> keys_b(np);
+        Gpu::DeviceVector<int> perm_b(np);
+        int* src_keys = keys_a.dataPtr();
+        int* dst_keys = keys_b.dataPtr();
+        int* src_perm = pperm;
+        int* dst_perm = perm_b.dataPtr();
+        for (int i = 0; i < np; ++i) {
+            src_keys[i] = keys[i];
+            src_perm[i] = i;
+        }
+        for (int shift = 0; shift < nbits; shift += radix_bits) {
+            std::array<int,radix+1> offset{};
+            for (int i = 0; i < np; ++i) {
+                ++offset[((src_keys[i] >> shift) & (radix-1)) + 1];
+            }
+            for (int d = 0; d < radix; ++d) offset[d+1] += offset[d];
+            for (int i = 0; i < np; ++i) {
+                const int pos = offset[(src_keys[i] >> shift) & (radix-1)]++;
+                dst_keys[pos] = src_keys[i];
+                dst_perm[pos] = src_perm[i];
+            }
+            std::swap(src_keys, dst_keys);
+            std::swap(src_perm, dst_perm);
+        }
+        if (src_perm != pperm) {
+            for (int i = 0; i < np; ++i) pperm[i] = src_perm[i];
+        }
+#endif
+    }
+
+    /** \brief Reorder the elements of `data`, so that the new i-th element
+     *         is the former element of index `perm[i]`
+     *
+     * \param[inout] data array (of one particle component) to be reordered
+     * \param[in] perm permutation to be applied
+     * \param[in] np number of elements
+     */
+    template <typename T>
+    void reorderElements (T* const AMREX_RESTRICT data,
+                          int const* const AMREX_RESTRICT perm,
+                          int const np)
+    {
+        Gpu::DeviceVector<T> tmp(np);
+        T* const AMREX_RESTRICT ptmp = tmp.dataPtr();
+        amrex::ParallelFor( np, [=] AMREX_GPU_DEVICE (int i) noexcept
+        {
+            ptmp[i] = data[perm[i]];
+        });
+        amrex::ParallelFor( np, [=] AMREX_GPU_DEVICE (int i) noexcept
+        {
+            data[i] = ptmp[i];
+        });
+        Gpu::synchronize();
+    }
+
+}
+
+/* \brief Sort the particles of each tile by the key of their bin
+ *        along a space-filling curve
+ *
+ *  The bins are boxes of `bin_size` cells within each tile, numbered along
+ *  a Morton or Hilbert curve (see GetParticleBin), so that bins that are
+ *  close in memory are also close in space in all directions.
+ *  The keys are computed in a single pass over the particles,
+ *  and then radix-sorted.
+ *
+ * \param bin_size size of the bins, in number of cells
+ * \param sort_order ParticleSortOrder::Morton or ParticleSortOrder::Hilbert
+ */
+void
+WarpXParticleContainer::SortParticlesAlongCurve (IntVect bin_size, int sort_order)
+{
+    WARPX_PROFILE("WarpXParticleContainer::SortParticlesAlongCurve");
+
+    for (int lev = 0; lev <= finestLevel(); ++lev)
+    {
+#ifdef _OPENMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+        for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti)
+        {
+            auto& ptile = ParticlesAt(lev, pti);
+            const int np = ptile.numParticles();
+            if (np == 0) continue;
+
+            ParticleType* const AMREX_RESTRICT pstruct = ptile.GetArrayOfStructs()().data();
+
+            // Compute the key of each particle
+            const GetParticleBin get_bin(pti.tilebox(), Geom(lev), bin_size, sort_order);
+            Gpu::DeviceVector<int> keys(np);
+            int* const AMREX_RESTRICT pkeys = keys.dataPtr();
+            amrex::ParallelFor( np, [=] AMREX_GPU_DEVICE (int i) noexcept
+            {
+                pkeys[i] = get_bin(pstruct[i]);
+            });
+
+            // Sort the keys
+            Gpu::DeviceVector<int> perm;
+            radixSortPermutation(keys, perm, np, get_bin.numBits()*AMREX_SPACEDIM);
+            int const* const AMREX_RESTRICT pperm = perm.dataPtr();
+
+            // Reorder all the particle components
+            reorderElements(pstruct, pperm, np);
+            auto& soa = ptile.GetStructOfArrays();
+            for (int comp = 0; comp < NumRealComps(); ++comp) {
+                reorderElements(soa.GetRealData(comp).dataPtr(), pperm, np);
+            }
+            for (int comp = 0; comp < NumIntComps(); ++comp) {
+                reorderElements(soa.GetIntData(comp).dataPtr(), pperm, np);
+            }
+        }
+    }
+}
+
+/* \brief Sort the particles of each tile by cell (lexicographic order),
+ *        using the cached cell bins
+ *
+ *  The permutation of the cell bins (see getCellBins) is applied to all the
+ *  particle components. The bins then simply become the identity permutation,
+ *  so that they remain valid for the collisions and the resampling, without
+ *  being rebuilt.
+ */
+void
+WarpXParticleContainer::SortParticlesByCell ()
+{
+    WARPX_PROFILE("WarpXParticleContainer::SortParticlesByCell");
+
+    for (int lev = 0; lev <= finestLevel(); ++lev)
+    {
+#ifdef _OPENMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+        for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti)
+        {
+            auto& ptile = ParticlesAt(lev, pti);
+            const int np = ptile.numParticles();
+            if (np == 0) continue;
+
+            auto& bins = getCellBins(lev, pti);
+            auto* const AMREX_RESTRICT pindices = bins.permutationPtr();
+            Gpu::DeviceVector<int> perm(np);
+            int* const AMREX_RESTRICT pperm = perm.dataPtr();
+            amrex::ParallelFor( np, [=] AMREX_GPU_DEVICE (int i) noexcept
+            {
+                pperm[i] = static_cast<int>(pindices[i]);
+            });
+
+            // Reorder all the particle components
+            reorderElements(ptile.GetArrayOfStructs()().data(), pperm, np);
+            auto& soa = ptile.GetStructOfArrays();
+            for (int comp = 0; comp < NumRealComps(); ++comp) {
+                reorderElements(soa.GetRealData(comp).dataPtr(), pperm, np);
+            }
+            for (int comp = 0; comp < NumIntComps(); ++comp) {
+                reorderElements(soa.GetIntData(comp).dataPtr(), pperm, np);
+            }
+
+            // The particles of each cell are now contiguous and in place
+            amrex::ParallelFor( np, [=] AMREX_GPU_DEVICE (int i) noexcept
+            {
+                pindices[i] = i;
+            });
+            Gpu::synchronize();
+        }
+    }
+}
@@ -16,7 +16,10 @@
 #include "Pusher/GetAndSetPosition.H"
 #include "Pusher/UpdatePosition.H"
 #include "Deposition/CurrentDeposition.H"
+#include "Deposition/VectorizedCurrentDeposition.H"
 #include "Deposition/ChargeDeposition.H"
+#include "Deposition/DepositionBox.H"
+#include "Sorting/FindParticlesInEachCell.H"
 
 #include <AMReX_AmrParGDB.H>
 
@@ -64,6 +67,11 @@ WarpXParticleContainer::WarpXParticleContainer (AmrCore* amr_core, int ispecies)
     local_jx.resize(num_threads);
     local_jy.resize(num_threads);
     local_jz.resize(num_threads);
+    local_particle_fields.resize(num_threads);
+    local_interleaved_fields.resize(num_threads);
+
+    // Resized here, so that the cache is never resized in parallel regions
+    cell_bins_cache.resize(amr_core->maxLevel()+1);
 }
 
 void
@@ -232,13 +240,161 @@ WarpXParticleContainer::DepositCurrent(WarpXParIter& pti,
     // If user decides not to deposit
     if (do_not_deposit) return;
 
-    const long ngJ = jx->nGrow();
     const std::array<Real,3>& dx = WarpX::CellSize(std::max(depos_lev,0));
     Real q = this->charge;
 
-    WARPX_PROFILE_VAR_NS("PPC::Evolve::Accumulate", blp_accumulate);
     WARPX_PROFILE_VAR_NS("PPC::CurrentDeposition", blp_deposit);
 
+    const auto GetPosition = GetParticlePosition(pti, offset);
+
+    // GPU, no tiling: deposit directly in jx
+    // CPU, tiling: deposit into local_jx
+    // CPU, colored tiles: deposit directly in jx
+    // (same for jx and jz)
+    const CurrentDepositionTile tile = PrepareCurrentDeposition(
+        pti, jx, jy, jz, offset, np_to_depose, thread_num, lev, depos_lev, dt);
+    auto & jx_fab = *tile.jx_fab;
+    auto & jy_fab = *tile.jy_fab;
+    auto & jz_fab = *tile.jz_fab;
+    Array4<Real> const& jx_arr = jx_fab.array();
+    Array4<Real> const& jy_arr = jy_fab.array();
+    Array4<Real> const& jz_arr = jz_fab.array();
+    const std::array<Real, 3>& xyzmin = tile.xyzmin;
+    const Dim3 lo = tile.lo;
+
+    WARPX_PROFILE_VAR_START(blp_deposit);
+    if (WarpX::current_deposition_algo == CurrentDepositionAlgo::Esirkepov) {
+#ifndef AMREX_USE_GPU
+        if (WarpX::do_vectorized_deposition) {
+            // CPU: no other thread writes to the current arrays of this tile
+            // (private buffer or colored tiles), so the vectorized kernel
+            // (without atomics) can be used
+            if        (WarpX::nox == 1){
+                doVectorizedEsirkepovDepositionShapeN<1>(
+                    GetPosition, wp.dataPtr() + offset, uxp.dataPtr() + offset,
+                    uyp.dataPtr() + offset, uzp.dataPtr() + offset, ion_lev,
+                    jx_arr, jy_arr, jz_arr, np_to_depose, dt, dx, xyzmin, lo, q,
+                    WarpX::n_rz_azimuthal_modes);
+            } else if (WarpX::nox == 2){
+                doVectorizedEsirkepovDepositionShapeN<2>(
+                    GetPosition, wp.dataPtr() + offset, uxp.dataPtr() + offset,
+                    uyp.dataPtr() + offset, uzp.dataPtr() + offset, ion_lev,
+                    jx_arr, jy_arr, jz_arr, np_to_depose, dt, dx, xyzmin, lo, q,
+                    WarpX::n_rz_azimuthal_modes);
+            } else if (WarpX::nox == 3){
+                doVectorizedEsirkepovDepositionShapeN<3>(
+                    GetPosition, wp.dataPtr() + offset, uxp.dataPtr() + offset,
+                    uyp.dataPtr() + offset, uzp.dataPtr() + offset, ion_lev,
+                    jx_arr, jy_arr, jz_arr, np_to_depose, dt, dx, xyzmin, lo, q,
+                    WarpX::n_rz_azimuthal_modes);
+            }
+        } else
+#endif
+        {
+            if        (WarpX::nox == 1){
+                doEsirkepovDepositionShapeN<1>(
+                    GetPosition, wp.dataPtr() + offset, uxp.dataPtr() + offset,
+                    uyp.dataPtr() + offset, uzp.dataPtr() + offset, ion_lev,
+                    jx_arr, jy_arr, jz_arr, np_to_depose, dt, dx, xyzmin, lo, q,
+                    WarpX::n_rz_azimuthal_modes);
+            } else if (WarpX::nox == 2){
+                doEsirkepovDepositionShapeN<2>(
+                    GetPosition, wp.dataPtr() + offset, uxp.dataPtr() + offset,
+                    uyp.dataPtr() + offset, uzp.dataPtr() + offset, ion_lev,
+                    jx_arr, jy_arr, jz_arr, np_to_depose, dt, dx, xyzmin, lo, q,
+                    WarpX::n_rz_azimuthal_modes);
+            } else if (WarpX::nox == 3){
+                doEsirkepovDepositionShapeN<3>(
+                    GetPosition, wp.dataPtr() + offset, uxp.dataPtr() + offset,
+                    uyp.dataPtr() + offset, uzp.dataPtr() + offset, ion_lev,
+                    jx_arr, jy_arr, jz_arr, np_to_depose, dt, dx, xyzmin, lo, q,
+                    WarpX::n_rz_azimuthal_modes);
+            }
+        }
+    } else if (WarpX::current_deposition_algo == CurrentDepositionAlgo::Vay) {
+        if        (WarpX::nox == 1){
+            doVayDepositionShapeN<1>(
+                GetPosition, wp.dataPtr() + offset, uxp.dataPtr() + offset,
+                uyp.dataPtr() + offset, uzp.dataPtr() + offset, ion_lev,
+                jx_fab, jy_fab, jz_fab, np_to_depose, dt, dx, xyzmin, lo, q,
+                WarpX::n_rz_azimuthal_modes );
+        } else if (WarpX::nox == 2){
+            doVayDepositionShapeN<2>(
+                GetPosition, wp.dataPtr() + offset, uxp.dataPtr() + offset,
+                uyp.dataPtr() + offset, uzp.dataPtr() + offset, ion_lev,
+                jx_fab, jy_fab, jz_fab, np_to_depose, dt, dx, xyzmin, lo, q,
+                WarpX::n_rz_azimuthal_modes );
+        } else if (WarpX::nox == 3){
+            doVayDepositionShapeN<3>(
+                GetPosition, wp.dataPtr() + offset, uxp.dataPtr() + offset,
+                uyp.dataPtr() + offset, uzp.dataPtr() + offset, ion_lev,
+                jx_fab, jy_fab, jz_fab, np_to_depose, dt, dx, xyzmin, lo, q,
+                WarpX::n_rz_azimuthal_modes );
+        }
+    } else {
+#ifndef AMREX_USE_GPU
+        if (WarpX::do_vectorized_deposition) {
+            // CPU: no other thread writes to the current arrays of this tile
+            // (private buffer or colored tiles), so the vectorized kernel
+            // (without atomics) can be used
+            if        (WarpX::nox == 1){
+                doVectorizedDepositionShapeN<1>(
+                    GetPosition, wp.dataPtr() + offset, uxp.dataPtr() + offset,
+                    uyp.dataPtr() + offset, uzp.dataPtr() + offset, ion_lev,
+                    jx_fab, jy_fab, jz_fab, np_to_depose, dt, dx,
+                    xyzmin, lo, q, WarpX::n_rz_azimuthal_modes);
+            } else if (WarpX::nox == 2){
+                doVectorizedDepositionShapeN<2>(
+                    GetPosition, wp.dataPtr() + offset, uxp.dataPtr() + offset,
+                    uyp.dataPtr() + offset, uzp.dataPtr() + offset, ion_lev,
+                    jx_fab, jy_fab, jz_fab, np_to_depose, dt, dx,
+                    xyzmin, lo, q, WarpX::n_rz_azimuthal_modes);
+            } else if (WarpX::nox == 3){
+                doVectorizedDepositionShapeN<3>(
+                    GetPosition, wp.dataPtr() + offset, uxp.dataPtr() + offset,
+                    uyp.dataPtr() + offset, uzp.dataPtr() + offset, ion_lev,
+                    jx_fab, jy_fab, jz_fab, np_to_depose, dt, dx,
+                    xyzmin, lo, q, WarpX::n_rz_azimuthal_modes);
+            }
+        } else
+#endif
+        {
+            if        (WarpX::nox == 1){
+                doDepositionShapeN<1>(
+                    GetPosition, wp.dataPtr() + offset, uxp.dataPtr() + offset,
+                    uyp.dataPtr() + offset, uzp.dataPtr() + offset, ion_lev,
+                    jx_fab, jy_fab, jz_fab, np_to_depose, dt, dx,
+                    xyzmin, lo, q, WarpX::n_rz_azimuthal_modes);
+            } else if (WarpX::nox == 2){
+                doDepositionShapeN<2>(
+                    GetPosition, wp.dataPtr() + offset, uxp.dataPtr() + offset,
+                    uyp.dataPtr() + offset, uzp.dataPtr() + offset, ion_lev,
+                    jx_fab, jy_fab, jz_fab, np_to_depose, dt, dx,
+                    xyzmin, lo, q, WarpX::n_rz_azimuthal_modes);
+            } else if (WarpX::nox == 3){
+                doDepositionShapeN<3>(
+                    GetPosition, wp.dataPtr() + offset, uxp.dataPtr() + offset,
+                    uyp.dataPtr() + offset, uzp.dataPtr() + offset, ion_lev,
+                    jx_fab, jy_fab, jz_fab, np_to_depose, dt, dx,
+                    xyzmin, lo, q, WarpX::n_rz_azimuthal_modes);
+            }
+        }
+    }
+    WARPX_PROFILE_VAR_STOP(blp_deposit);
+
+    FinishCurrentDeposition(pti, jx, jy, jz, thread_num, tile);
+}
+
+WarpXParticleContainer::CurrentDepositionTile
+WarpXParticleContainer::PrepareCurrentDeposition (const WarpXParIter& pti,
+                                                  MultiFab* jx, MultiFab* jy, MultiFab* jz,
+                                                  const long offset, const long np_to_depose,
+                                                  int thread_num, int lev, int depos_lev,
+                                                  Real dt, int n_move)
+{
+    CurrentDepositionTile tile;
+    const long ngJ = jx->nGrow();
+    const std::array<Real,3>& dx = WarpX::CellSize(std::max(depos_lev,0));
 
     // Get tile box where current is deposited.
     // The tile box is different when depositing in the buffers (depos_lev<lev)
@@ -252,59 +408,63 @@ WarpXParticleContainer::DepositCurrent(WarpXParIter& pti,
     }
 
     // Staggered tile boxes (different in each direction)
-    Box tbx = convert( tilebox, jx->ixType().toIntVect() );
-    Box tby = convert( tilebox, jy->ixType().toIntVect() );
-    Box tbz = convert( tilebox, jz->ixType().toIntVect() );
+    tile.tbx = convert( tilebox, jx->ixType().toIntVect() );
+    tile.tby = convert( tilebox, jy->ixType().toIntVect() );
+    tile.tbz = convert( tilebox, jz->ixType().toIntVect() );
     tilebox.grow(ngJ);
 
 #ifdef AMREX_USE_GPU
-    // No tiling on GPU: jx_ptr points to the full
-    // jx array (same for jy_ptr and jz_ptr).
-    auto & jx_fab = jx->get(pti);
-    auto & jy_fab = jy->get(pti);
-    auto & jz_fab = jz->get(pti);
-    Array4<Real> const& jx_arr = jx->array(pti);
-    Array4<Real> const& jy_arr = jy->array(pti);
-    Array4<Real> const& jz_arr = jz->array(pti);
+    // No tiling on GPU: jx_fab points to the full
+    // jx array (same for jy_fab and jz_fab).
+    tile.jx_fab = &(jx->get(pti));
+    tile.jy_fab = &(jy->get(pti));
+    tile.jz_fab = &(jz->get(pti));
 #else
-    // Tiling is on: jx_ptr points to local_jx[thread_num]
-    // (same for jy_ptr and jz_ptr)
-    tbx.grow(ngJ);
-    tby.grow(ngJ);
-    tbz.grow(ngJ);
-
-    local_jx[thread_num].resize(tbx, jx->nComp());
-    local_jy[thread_num].resize(tby, jy->nComp());
-    local_jz[thread_num].resize(tbz, jz->nComp());
-
-    // local_jx[thread_num] is set to zero
-    local_jx[thread_num].setVal(0.0);
-    local_jy[thread_num].setVal(0.0);
-    local_jz[thread_num].setVal(0.0);
-
-    auto & jx_fab = local_jx[thread_num];
-    auto & jy_fab = local_jy[thread_num];
-    auto & jz_fab = local_jz[thread_num];
-    Array4<Real> const& jx_arr = local_jx[thread_num].array();
-    Array4<Real> const& jy_arr = local_jy[thread_num].array();
-    Array4<Real> const& jz_arr = local_jz[thread_num].array();
-#endif
-    // GPU, no tiling: deposit directly in jx
-    // CPU, tiling: deposit into local_jx
-    // (same for jx and jz)
+    // Tiling is on: jx_fab points to local_jx[thread_num]
+    // (same for jy_fab and jz_fab), unless the tiles are
+    // colored, in which case it points to the full jx array
+    tile.tbx.grow(ngJ);
+    tile.tby.grow(ngJ);
+    tile.tbz.grow(ngJ);
+
+    if (!deposit_in_place) {
+        local_jx[thread_num].resize(tile.tbx, jx->nComp());
+        local_jy[thread_num].resize(tile.tby, jy->nComp());
+        local_jz[thread_num].resize(tile.tbz, jz->nComp());
+    }
 
-    const auto GetPosition = GetParticlePosition(pti, offset);
+    tile.jx_fab = deposit_in_place ? &(jx->get(pti)) : &local_jx[thread_num];
+    tile.jy_fab = deposit_in_place ? &(jy->get(pti)) : &local_jy[thread_num];
+    tile.jz_fab = deposit_in_place ? &(jz->get(pti)) : &local_jz[thread_num];
+#endif
 
     // Lower corner of tile box physical domain
     // Note that this includes guard cells since it is after tilebox.ngrow
-    const Dim3 lo = lbound(tilebox);
+    tile.lo = lbound(tilebox);
     // Take into account Galilean shift
     auto& warpx_instance = WarpX::GetInstance();
     Real cur_time = warpx_instance.gett_new(lev);
     const auto& time_of_last_gal_shift = warpx_instance.time_of_last_gal_shift;
     Real time_shift = (cur_time + 0.5*dt - time_of_last_gal_shift);
     amrex::Array<amrex::Real,3> galilean_shift = { v_galilean[0]* time_shift, v_galilean[1]*time_shift, v_galilean[2]*time_shift };
-    const std::array<Real, 3>& xyzmin = WarpX::LowerCorner(tilebox, galilean_shift, depos_lev);
+    tile.xyzmin = WarpX::LowerCorner(tilebox, galilean_shift, depos_lev);
+
+#ifndef AMREX_USE_GPU
+    // CPU, tiling: only the cells that the particles can deposit to
+    // are set to zero in local_jx, and then added to jx
+    // (same for jy and jz)
+    if (!deposit_in_place) {
+        const auto GetPosition = GetParticlePosition(pti, offset);
+        tile.tbx = getDepositionBox(GetPosition, np_to_depose, dx, tile.xyzmin, tile.tbx, WarpX::nox, n_move);
+        tile.tby = getDepositionBox(GetPosition, np_to_depose, dx, tile.xyzmin, tile.tby, WarpX::nox, n_move);
+        tile.tbz = getDepositionBox(GetPosition, np_to_depose, dx, tile.xyzmin, tile.tbz, WarpX::nox, n_move);
+        local_jx[thread_num].setVal(0.0, tile.tbx, 0, jx->nComp());
+        local_jy[thread_num].setVal(0.0, tile.tby, 0, jy->nComp());
+        local_jz[thread_num].setVal(0.0, tile.tbz, 0, jz->nComp());
+    }
+#else
+    amrex::ignore_unused(offset, np_to_depose, thread_num, dx, n_move);
+#endif
 
     if (WarpX::current_deposition_algo == CurrentDepositionAlgo::Esirkepov) {
         if (WarpX::do_nodal==1) {
@@ -314,79 +474,25 @@ WarpXParticleContainer::DepositCurrent(WarpXParIter& pti,
             amrex::Abort("The Esirkepov algorithm cannot be used with the Galilean algorithm.");
         }
     }
+    return tile;
+}
 
-    WARPX_PROFILE_VAR_START(blp_deposit);
-    if (WarpX::current_deposition_algo == CurrentDepositionAlgo::Esirkepov) {
-        if        (WarpX::nox == 1){
-            doEsirkepovDepositionShapeN<1>(
-                GetPosition, wp.dataPtr() + offset, uxp.dataPtr() + offset,
-                uyp.dataPtr() + offset, uzp.dataPtr() + offset, ion_lev,
-                jx_arr, jy_arr, jz_arr, np_to_depose, dt, dx, xyzmin, lo, q,
-                WarpX::n_rz_azimuthal_modes);
-        } else if (WarpX::nox == 2){
-            doEsirkepovDepositionShapeN<2>(
-                GetPosition, wp.dataPtr() + offset, uxp.dataPtr() + offset,
-                uyp.dataPtr() + offset, uzp.dataPtr() + offset, ion_lev,
-                jx_arr, jy_arr, jz_arr, np_to_depose, dt, dx, xyzmin, lo, q,
-                WarpX::n_rz_azimuthal_modes);
-        } else if (WarpX::nox == 3){
-            doEsirkepovDepositionShapeN<3>(
-                GetPosition, wp.dataPtr() + offset, uxp.dataPtr() + offset,
-                uyp.dataPtr() + offset, uzp.dataPtr() + offset, ion_lev,
-                jx_arr, jy_arr, jz_arr, np_to_depose, dt, dx, xyzmin, lo, q,
-                WarpX::n_rz_azimuthal_modes);
-        }
-    } else if (WarpX::current_deposition_algo == CurrentDepositionAlgo::Vay) {
-        if        (WarpX::nox == 1){
-            doVayDepositionShapeN<1>(
-                GetPosition, wp.dataPtr() + offset, uxp.dataPtr() + offset,
-                uyp.dataPtr() + offset, uzp.dataPtr() + offset, ion_lev,
-                jx_fab, jy_fab, jz_fab, np_to_depose, dt, dx, xyzmin, lo, q,
-                WarpX::n_rz_azimuthal_modes );
-        } else if (WarpX::nox == 2){
-            doVayDepositionShapeN<2>(
-                GetPosition, wp.dataPtr() + offset, uxp.dataPtr() + offset,
-                uyp.dataPtr() + offset, uzp.dataPtr() + offset, ion_lev,
-                jx_fab, jy_fab, jz_fab, np_to_depose, dt, dx, xyzmin, lo, q,
-                WarpX::n_rz_azimuthal_modes );
-        } else if (WarpX::nox == 3){
-            doVayDepositionShapeN<3>(
-                GetPosition, wp.dataPtr() + offset, uxp.dataPtr() + offset,
-                uyp.dataPtr() + offset, uzp.dataPtr() + offset, ion_lev,
-                jx_fab, jy_fab, jz_fab, np_to_depose, dt, dx, xyzmin, lo, q,
-                WarpX::n_rz_azimuthal_modes );
-        }
-    } else {
-        if        (WarpX::nox == 1){
-            doDepositionShapeN<1>(
-                GetPosition, wp.dataPtr() + offset, uxp.dataPtr() + offset,
-                uyp.dataPtr() + offset, uzp.dataPtr() + offset, ion_lev,
-                jx_fab, jy_fab, jz_fab, np_to_depose, dt, dx,
-                xyzmin, lo, q, WarpX::n_rz_azimuthal_modes);
-        } else if (WarpX::nox == 2){
-            doDepositionShapeN<2>(
-                GetPosition, wp.dataPtr() + offset, uxp.dataPtr() + offset,
-                uyp.dataPtr() + offset, uzp.dataPtr() + offset, ion_lev,
-                jx_fab, jy_fab, jz_fab, np_to_depose, dt, dx,
-                xyzmin, lo, q, WarpX::n_rz_azimuthal_modes);
-        } else if (WarpX::nox == 3){
-            doDepositionShapeN<3>(
-                GetPosition, wp.dataPtr() + offset, uxp.dataPtr() + offset,
-                uyp.dataPtr() + offset, uzp.dataPtr() + offset, ion_lev,
-                jx_fab, jy_fab, jz_fab, np_to_depose, dt, dx,
-                xyzmin, lo, q, WarpX::n_rz_azimuthal_modes);
-        }
-    }
-    WARPX_PROFILE_VAR_STOP(blp_deposit);
-
+void
+WarpXParticleContainer::FinishCurrentDeposition (const WarpXParIter& pti,
+                                                 MultiFab* jx, MultiFab* jy, MultiFab* jz,
+                                                 int thread_num, const CurrentDepositionTile& tile)
+{
 #ifndef AMREX_USE_GPU
-    WARPX_PROFILE_VAR_START(blp_accumulate);
-    // CPU, tiling: atomicAdd local_jx into jx
-    // (same for jx and jz)
-    (*jx)[pti].atomicAdd(local_jx[thread_num], tbx, tbx, 0, 0, jx->nComp());
-    (*jy)[pti].atomicAdd(local_jy[thread_num], tby, tby, 0, 0, jy->nComp());
-    (*jz)[pti].atomicAdd(local_jz[thread_num], tbz, tbz, 0, 0, jz->nComp());
-    WARPX_PROFILE_VAR_STOP(blp_accumulate);
+    if (!deposit_in_place) {
+        WARPX_PROFILE("PPC::Evolve::Accumulate");
+        // CPU, tiling: atomicAdd local_jx into jx
+        // (same for jx and jz)
+        AccumulateTileBuffer(jx, pti, local_jx[thread_num], tile.tbx, 0, jx->nComp());
+        AccumulateTileBuffer(jy, pti, local_jy[thread_num], tile.tby, 0, jy->nComp());
+        AccumulateTileBuffer(jz, pti, local_jz[thread_num], tile.tbz, 0, jz->nComp());
+    }
+#else
+    amrex::ignore_unused(pti, jx, jy, jz, thread_num, tile);
 #endif
 }
 
@@ -444,7 +550,7 @@ WarpXParticleContainer::DepositCharge (WarpXParIter& pti, RealVector& wp,
     }
 
     tilebox.grow(ngRho);
-    const Box tb = amrex::convert( tilebox, rho->ixType().toIntVect() );
+    Box tb = amrex::convert( tilebox, rho->ixType().toIntVect() );
 
     const int nc = WarpX::ncomps;
 
@@ -453,17 +559,20 @@ WarpXParticleContainer::DepositCharge (WarpXParIter& pti, RealVector& wp,
     MultiFab rhoi(*rho, amrex::make_alias, icomp*nc, nc);
     auto & rho_fab = rhoi.get(pti);
 #else
-    // Tiling is on: rho_fab points to local_rho[thread_num]
-
-    local_rho[thread_num].resize(tb, nc);
-
-    // local_rho[thread_num] is set to zero
-    local_rho[thread_num].setVal(0.0);
+    // Tiling is on: rho_fab points to local_rho[thread_num], unless the
+    // tiles are colored, in which case it points to the full rho array
+    FArrayBox rhoi;
+    if (deposit_in_place) {
+        rhoi = FArrayBox((*rho)[pti], amrex::make_alias, icomp*nc, nc);
+    } else {
+        local_rho[thread_num].resize(tb, nc);
+    }
 
-    auto & rho_fab = local_rho[thread_num];
+    auto & rho_fab = deposit_in_place ? rhoi : local_rho[thread_num];
 #endif
     // GPU, no tiling: deposit directly in rho
     // CPU, tiling: deposit into local_rho
+    // CPU, colored tiles: deposit directly in rho
 
     const auto GetPosition = GetParticlePosition(pti, offset);
 
@@ -487,6 +596,15 @@ WarpXParticleContainer::DepositCharge (WarpXParIter& pti, RealVector& wp,
     // Indices of the lower bound
     const Dim3 lo = lbound(tilebox);
 
+#ifndef AMREX_USE_GPU
+    // CPU, tiling: only the cells that the particles can deposit to
+    // are set to zero in local_rho, and then added to rho
+    if (!deposit_in_place) {
+        tb = getDepositionBox(GetPosition, np_to_depose, dx, xyzmin, tb, WarpX::nox);
+        local_rho[thread_num].setVal(0.0, tb, 0, nc);
+    }
+#endif
+
     WARPX_PROFILE_VAR_START(blp_ppc_chd);
     if        (WarpX::nox == 1){
         doChargeDepositionShapeN<1>(GetPosition, wp.dataPtr()+offset, ion_lev,
@@ -504,14 +622,36 @@ WarpXParticleContainer::DepositCharge (WarpXParIter& pti, RealVector& wp,
     WARPX_PROFILE_VAR_STOP(blp_ppc_chd);
 
 #ifndef AMREX_USE_GPU
-    WARPX_PROFILE_VAR_START(blp_accumulate);
+    if (!deposit_in_place) {
+        WARPX_PROFILE_VAR_START(blp_accumulate);
 
-    (*rho)[pti].atomicAdd(local_rho[thread_num], tb, tb, 0, icomp*nc, nc);
+        AccumulateTileBuffer(rho, pti, local_rho[thread_num], tb, icomp*nc, nc);
 
-    WARPX_PROFILE_VAR_STOP(blp_accumulate);
+        WARPX_PROFILE_VAR_STOP(blp_accumulate);
+    }
 #endif
 }
 
+void
+WarpXParticleContainer::AccumulateTileBuffer (MultiFab* mf, const WarpXParIter& pti,
+                                              const FArrayBox& local, const Box& bx,
+                                              int dcomp, int ncomp)
+{
+    if (WarpX::do_deterministic_deposition) {
+        deposition_buffers.add(mf, dcomp, pti.GetPairIndex(), local, bx, ncomp);
+    } else {
+        (*mf)[pti].atomicAdd(local, bx, bx, 0, dcomp, ncomp);
+    }
+}
+
+void
+WarpXParticleContainer::ReduceDepositionBuffers ()
+{
+    if (deposition_buffers.empty()) return;
+    WARPX_PROFILE("WPC::ReduceDepositionBuffers()");
+    deposition_buffers.reduce();
+}
+
 void
 WarpXParticleContainer::DepositCharge (amrex::Vector<std::unique_ptr<amrex::MultiFab> >& rho,
                                         bool local, bool reset,
@@ -552,6 +692,7 @@ WarpXParticleContainer::DepositCharge (amrex::Vector<std::unique_ptr<amrex::Mult
 #ifdef _OPENMP
         }
 #endif
+        ReduceDepositionBuffers();
 
 #ifdef WARPX_DIM_RZ
         if (do_rz_volume_scaling) {
@@ -623,6 +764,7 @@ WarpXParticleContainer::GetChargeDensity (int lev, bool local)
 #ifdef _OPENMP
     }
 #endif
+    ReduceDepositionBuffers();
 
 #ifdef WARPX_DIM_RZ
     WarpX::GetInstance().ApplyInverseVolumeScalingToChargeDensity(rho.get(), lev);
@@ -772,6 +914,46 @@ Real WarpXParticleContainer::maxParticleVelocity(bool local) {
     return max_v;
 }
 
+WarpXParticleContainer::CellBins&
+WarpXParticleContainer::getCellBins (int lev, MFIter const& mfi)
+{
+    CellBinsCache* cache;
+    // Only the lookup in the map needs to be serialized: the entry of
+    // each tile is then only accessed by the thread that handles this tile
+#ifdef _OPENMP
+#pragma omp critical (warpx_cell_bins_cache)
+#endif
+    cache = &cell_bins_cache[lev][std::make_pair(mfi.index(), mfi.LocalTileIndex())];
+
+    const auto& ptile = ParticlesAt(lev, mfi);
+    const Box cbx = mfi.tilebox(IntVect::TheZeroVector());
+    const long np = ptile.numParticles();
+    if (!cache->valid || cache->np != np || cache->box != cbx) {
+        cache->bins = findParticlesInEachCell(lev, mfi, ptile);
+        cache->box = cbx;
+        cache->np = np;
+        cache->valid = true;
+    }
+    return cache->bins;
+}
+
+void
+WarpXParticleContainer::invalidateCellBins () noexcept
+{
+    for (auto& cache_lev : cell_bins_cache) {
+        for (auto& cache : cache_lev) {
+            cache.second.valid = false;
+        }
+    }
+}
+
+void
+WarpXParticleContainer::Redistribute (int lev_min, int lev_max, int nGrow, int local)
+{
+    amrex::ParticleContainer<0,0,PIdx::nattribs>::Redistribute(lev_min, lev_max, nGrow, local);
+    invalidateCellBins();
+}
+
 void
 WarpXParticleContainer::PushX (amrex::Real dt)
 {
@@ -788,6 +970,8 @@ WarpXParticleContainer::PushX (int lev, amrex::Real dt)
 
     if (do_not_push) return;
 
+    invalidateCellBins();
+
     amrex::LayoutData<amrex::Real>* cost = WarpX::getCosts(lev);
 
 #ifdef _OPENMP
@@ -71,6 +71,13 @@ const std::map<std::string, int> MacroscopicSolver_algo_to_int = {
     {"default", MacroscopicSolverAlgo::BackwardEuler},
 };
 
+const std::map<std::string, int> particle_sort_order_to_int = {
+    {"lexicographic", ParticleSortOrder::Lexicographic },
+    {"morton",        ParticleSortOrder::Morton },
+    {"hilbert",       ParticleSortOrder::Hilbert },
+    {"default",       ParticleSortOrder::Lexicographic }
+};
+
 int
 GetAlgorithmInteger( amrex::ParmParse& pp, const char* pp_search_key ){
 
@@ -98,6 +105,8 @@ GetAlgorithmInteger( amrex::ParmParse& pp, const char* pp_search_key ){
         algo_to_int = MaxwellSolver_medium_algo_to_int;
     } else if (0 == std::strcmp(pp_search_key, "macroscopic_sigma_method")) {
         algo_to_int = MacroscopicSolver_algo_to_int;
+    } else if (0 == std::strcmp(pp_search_key, "sort_order")) {
+        algo_to_int = particle_sort_order_to_int;
     } else {
         std::string pp_search_string = pp_search_key;
         amrex::Abort("Unknown algorithm type: " + pp_search_string);
@@ -107,7 +116,7 @@ GetAlgorithmInteger( amrex::ParmParse& pp, const char* pp_search_key ){
     if (algo_to_int.count(algo) == 0) {
         // Not a valid key ; print error message
         std::string pp_search_string = pp_search_key;
-        std::string error_message = "Invalid string for algo." + pp_search_string
+        std::string error_message = "Invalid string for " + pp.getPrefix() + "." + pp_search_string
             + ": " + algo + ".\nThe valid values are:\n";
         for ( const auto &valid_pair : algo_to_int ) {
             if (valid_pair.first != "default"){
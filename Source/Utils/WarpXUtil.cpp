@@ -12,7 +12,10 @@
 #include <AMReX_ParmParse.H>
 
 #include <cmath>
+#include <cstdint>
 #include <fstream>
+#include <iomanip>
+#include <sstream>
 
 
 using namespace amrex;
@@ -176,6 +179,18 @@ namespace WarpXUtilIO{
         of.close();
         return  of.good();
     }
+
+    std::string HashBinaryData(const amrex::Vector<char>& data)
+    {
+        std::uint64_t hash = 14695981039346656037ull;
+        for (const char c : data){
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 1099511628211ull;
+        }
+        std::ostringstream ss;
+        ss << std::hex << std::setfill('0') << std::setw(16) << hash;
+        return ss.str();
+    }
 }
 
 void Store_parserString(amrex::ParmParse& pp, std::string query_string,
@@ -83,6 +83,8 @@ long WarpX::noz = 1;
 
 bool WarpX::use_fdtd_nci_corr = false;
 bool WarpX::galerkin_interpolation = true;
+bool WarpX::do_vectorized_gather = false;
+Real WarpX::vectorized_gather_min_ppc = 1.;
 
 bool WarpX::use_filter        = false;
 bool WarpX::use_kspace_filter       = false;
@@ -95,6 +97,8 @@ int WarpX::num_mirrors = 0;
 
 IntervalsParser WarpX::sort_intervals;
 amrex::IntVect WarpX::sort_bin_size(AMREX_D_DECL(1,1,1));
+bool WarpX::sort_incremental = false;
+int WarpX::sort_order;
 
 bool WarpX::do_back_transformed_diagnostics = false;
 std::string WarpX::lab_data_directory = "lab_frame_data";
@@ -102,12 +106,18 @@ int  WarpX::num_snapshots_lab = std::numeric_limits<int>::lowest();
 Real WarpX::dt_snapshots_lab  = std::numeric_limits<Real>::lowest();
 bool WarpX::do_back_transformed_fields = true;
 bool WarpX::do_back_transformed_particles = true;
+bool WarpX::do_lazy_back_transformed_particles = false;
 
 int  WarpX::num_slice_snapshots_lab = 0;
 Real WarpX::dt_slice_snapshots_lab;
 Real WarpX::particle_slice_width_lab = 0.0;
 
 bool WarpX::do_dynamic_scheduling = true;
+bool WarpX::do_fused_gather_push_deposit = false;
+bool WarpX::do_colored_deposition = false;
+int WarpX::tile_split_size = 0;
+bool WarpX::do_deterministic_deposition = false;
+bool WarpX::do_vectorized_deposition = false;
 
 int WarpX::do_electrostatic = 0;
 int WarpX::do_subcycling = 0;
@@ -447,6 +457,10 @@ WarpX::ReadParameters ()
 
             pp.query("do_back_transformed_fields", do_back_transformed_fields);
 
+            pp.query("do_lazy_back_transformed_particles", do_lazy_back_transformed_particles);
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!do_lazy_back_transformed_particles || do_subcycling == 0,
+                   "warpx.do_lazy_back_transformed_particles cannot be used with subcycling.");
+
             AMREX_ALWAYS_ASSERT_WITH_MESSAGE(do_moving_window,
                    "The moving window should be on if using the boosted frame diagnostic.");
 
@@ -501,6 +515,8 @@ WarpX::ReadParameters ()
             for (int i=0; i<AMREX_SPACEDIM; i++)
                 sort_bin_size[i] = vect_sort_bin_size[i];
         }
+        pp.query("sort_incremental", sort_incremental);
+        sort_order = GetAlgorithmInteger(pp, "sort_order");
 
         double quantum_xi;
         int quantum_xi_is_specified = pp.query("quantum_xi", quantum_xi);
@@ -576,6 +592,15 @@ WarpX::ReadParameters ()
         pp.query("load_balance_efficiency_ratio_threshold", load_balance_efficiency_ratio_threshold);
 
         pp.query("do_dynamic_scheduling", do_dynamic_scheduling);
+        pp.query("do_fused_gather_push_deposit", do_fused_gather_push_deposit);
+        pp.query("do_colored_deposition", do_colored_deposition);
+        pp.query("tile_split_size", tile_split_size);
+        pp.query("do_deterministic_deposition", do_deterministic_deposition);
+#ifdef AMREX_USE_GPU
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!do_deterministic_deposition,
+            "warpx.do_deterministic_deposition is only available on CPU");
+#endif
+        pp.query("do_vectorized_deposition", do_vectorized_deposition);
 
         pp.query("do_nodal", do_nodal);
         // Use same shape factors in all directions, for gathering
@@ -623,6 +648,8 @@ WarpX::ReadParameters ()
         pp.query("noz", noz);
 
         pp.query("galerkin_scheme",galerkin_interpolation);
+        pp.query("vectorized_gather", do_vectorized_gather);
+        pp.query("vectorized_gather_min_ppc", vectorized_gather_min_ppc);
 
         AMREX_ALWAYS_ASSERT_WITH_MESSAGE( nox == noy and nox == noz ,
             "warpx.nox, noy and noz must be equal");
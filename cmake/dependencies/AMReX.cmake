@@ -53,9 +53,13 @@ macro(find_amrex)
 
         if(WarpX_PRECISION STREQUAL "double")
             set(ENABLE_DP ON CACHE INTERNAL "")
-            set(ENABLE_DP_PARTICLES ON CACHE INTERNAL "")
         else()
             set(ENABLE_DP OFF CACHE INTERNAL "")
+        endif()
+
+        if(WarpX_PARTICLE_PRECISION STREQUAL "double")
+            set(ENABLE_DP_PARTICLES ON CACHE INTERNAL "")
+        else()
             set(ENABLE_DP_PARTICLES OFF CACHE INTERNAL "")
         endif()
 
@@ -140,8 +144,13 @@ macro(find_amrex)
         else()
             set(COMP_DIM ${WarpX_DIMS}D)
         endif()
+        if(WarpX_PARTICLE_PRECISION STREQUAL "double")
+            set(COMP_PARTICLE_PRECISION DPARTICLES)
+        else()
+            set(COMP_PARTICLE_PRECISION)
+        endif()
 
-        find_package(AMReX 20.05 CONFIG REQUIRED COMPONENTS ${COMP_ASCENT} ${COMP_DIM} PARTICLES DPARTICLES DP TINYP LSOLVERS FINTERFACES)
+        find_package(AMReX 20.05 CONFIG REQUIRED COMPONENTS ${COMP_ASCENT} ${COMP_DIM} PARTICLES ${COMP_PARTICLE_PRECISION} DP TINYP LSOLVERS FINTERFACES)
         message(STATUS "AMReX: Found version '${AMReX_VERSION}'")
     endif()
 endmacro()